@@ -8,8 +8,14 @@
 #include "iris/Configuration.h"
 #include "iris/Log.h"
 #include "iris/VideoAnalyser.h"
+#include "iris/Result.h"
+#include <opencv2/core/utility.hpp>
 #include <algorithm>
 #include <filesystem>
+#include <set>
+#include <atomic>
+#include <thread>
+#include <chrono>
 
 
 
@@ -74,6 +80,204 @@ bool GetVideoFiles(std::vector<std::string>& videoFiles)
 	}
 }
 
+//Matches a file name against a pattern with * (any sequence) and ? (any character) wildcards
+bool WildcardMatch(const char* pattern, const char* str)
+{
+	if (*pattern == '\0')
+	{
+		return *str == '\0';
+	}
+	if (*pattern == '*')
+	{
+		return WildcardMatch(pattern + 1, str) || (*str != '\0' && WildcardMatch(pattern, str + 1));
+	}
+	if (*str != '\0' && (*pattern == '?' || *pattern == *str))
+	{
+		return WildcardMatch(pattern + 1, str + 1);
+	}
+	return false;
+}
+
+//Adds the files that match the glob, wildcards are only supported in the file name (e.g. clips/*.mp4)
+void GetGlobFiles(const std::string& glob, std::vector<std::string>& videoFiles)
+{
+	std::filesystem::path globPath(glob);
+	std::filesystem::path dir = globPath.has_parent_path() ? globPath.parent_path() : std::filesystem::path(".");
+	std::string filePattern = globPath.filename().string();
+
+	if (!std::filesystem::is_directory(dir))
+	{
+		LOG_CORE_ERROR("Directory {} of glob {} does not exist", dir.string(), glob);
+		return;
+	}
+
+	std::vector<std::string> matches;
+	for (const auto& entry : std::filesystem::directory_iterator{ dir })
+	{
+		if (entry.is_regular_file() && WildcardMatch(filePattern.c_str(), entry.path().filename().string().c_str()))
+		{
+			matches.emplace_back(entry.path().string());
+		}
+	}
+	std::sort(matches.begin(), matches.end());
+	videoFiles.insert(videoFiles.end(), matches.begin(), matches.end());
+}
+
+//Adds the files listed in a text file, one video path per line
+void GetListFiles(const char* listFile, std::vector<std::string>& videoFiles)
+{
+	std::ifstream list(listFile);
+	if (!list.is_open())
+	{
+		LOG_CORE_ERROR("List file {} could not be opened", listFile);
+		return;
+	}
+
+	std::string line;
+	while (std::getline(list, line))
+	{
+		line.erase(line.find_last_not_of(" \t\r") + 1);
+		if (!line.empty() && line[0] != '#')
+		{
+			videoFiles.emplace_back(line);
+		}
+	}
+}
+
+struct VideoSummary
+{
+	std::string video;
+	bool analysed = false; //false if the video could not be analysed
+	iris::Result result;
+};
+
+//Analyses the videos with batchSize videos running at the same time, each one on its own VideoAnalyser
+void AnalyseVideos(iris::Configuration& configuration, bool flagJson, const std::vector<std::string>& videoFiles, unsigned int batchSize, std::vector<VideoSummary>& summaries)
+{
+	summaries.resize(videoFiles.size());
+	std::atomic<size_t> nextVideo = 0;
+
+	//results are written to a directory named after the video file, videos with the same file name
+	//in different directories would write to the same files so they also get their batch index
+	std::vector<std::string> fileNames(videoFiles.size());
+	for (size_t i = 0; i < videoFiles.size(); i++)
+	{
+		fileNames[i] = std::filesystem::path(videoFiles[i]).filename().string();
+	}
+	std::vector<std::string> resultsNames = fileNames;
+	std::set<std::string> usedNames(fileNames.begin(), fileNames.end());
+	for (size_t i = 0; i < videoFiles.size(); i++)
+	{
+		if (std::count(fileNames.begin(), fileNames.end(), fileNames[i]) > 1)
+		{
+			//the index is increased while the name is the file name of another video or the name given to one
+			size_t index = i + 1;
+			do
+			{
+				resultsNames[i] = fileNames[i] + "_" + std::to_string(index++);
+			} while (usedNames.count(resultsNames[i]) > 0);
+			usedNames.insert(resultsNames[i]);
+			LOG_CORE_WARNING("Video {} has the same file name as another video, its results are written to {}", videoFiles[i], configuration.GetResultsPath() + resultsNames[i]);
+		}
+	}
+
+	//the OpenCV threads are shared by the process, they are split between the analysers once instead
+	//of every analyser setting the number of threads for its own video
+	const size_t analysers = std::min<size_t>(batchSize, videoFiles.size());
+	if (analysers > 1)
+	{
+		int cvThreads = std::max(1, (int)(std::thread::hardware_concurrency() / analysers));
+		cv::setNumThreads(cvThreads);
+		LOG_CORE_INFO("Number of threads used by each of the {} analysers: {}", analysers, cvThreads);
+	}
+
+	auto analyseNextVideos = [&]()
+	{
+		iris::VideoAnalyser vA(&configuration);
+		vA.SetOptimalCvThreadsEnabled(analysers <= 1);
+		for (size_t i = nextVideo++; i < videoFiles.size(); i = nextVideo++)
+		{
+			summaries[i].video = videoFiles[i];
+			try
+			{
+				vA.AnalyseVideo(flagJson, videoFiles[i].c_str(), &summaries[i].result, resultsNames[i].c_str());
+				summaries[i].analysed = true;
+			}
+			catch (const std::exception& ex)
+			{
+				LOG_CORE_ERROR("Video {} could not be analysed: {}", videoFiles[i], ex.what());
+				vA.DeInit();
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < batchSize && i < videoFiles.size(); i++)
+	{
+		workers.emplace_back(analyseNextVideos);
+	}
+	analyseNextVideos();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+std::string ToString(iris::AnalysisResult result)
+{
+	json j = result;
+	return j.get<std::string>();
+}
+
+//Writes the results of all the analysed videos to a single csv file
+void WriteSummary(iris::Configuration& config, const std::vector<VideoSummary>& summaries)
+{
+	std::string summaryPath = config.GetResultsPath() + "summary.csv";
+	std::ofstream summary(summaryPath);
+	if (!summary.is_open())
+	{
+		LOG_CORE_ERROR("Summary file {} could not be created", summaryPath);
+		return;
+	}
+
+	summary << "Video,OverallResult,Results,TotalFrame,VideoLen,AnalysisTime,"
+		<< "LuminanceFlashFailFrames,LuminanceExtendedFailFrames,LuminancePassWithWarningFrames,"
+		<< "RedFlashFailFrames,RedExtendedFailFrames,RedPassWithWarningFrames,PatternFailFrames\n";
+
+	int failed = 0, warnings = 0, errors = 0;
+	for (const VideoSummary& videoSummary : summaries)
+	{
+		summary << '"' << videoSummary.video << '"' << ',';
+		if (!videoSummary.analysed)
+		{
+			summary << "Error\n";
+			errors++;
+			continue;
+		}
+
+		const iris::Result& result = videoSummary.result;
+		std::string results;
+		for (auto analysisResult : result.Results)
+		{
+			results += (results.empty() ? "" : ";") + ToString(analysisResult);
+		}
+
+		summary << ToString(result.OverallResult) << ',' << results << ',' << result.TotalFrame << ','
+			<< iris::msToTimeSpan(result.VideoLen) << ',' << iris::msToTimeSpan(result.AnalysisTime) << ','
+			<< result.totalLuminanceIncidents.flashFailFrames << ',' << result.totalLuminanceIncidents.extendedFailFrames << ','
+			<< result.totalLuminanceIncidents.passWithWarningFrames << ',' << result.totalRedIncidents.flashFailFrames << ','
+			<< result.totalRedIncidents.extendedFailFrames << ',' << result.totalRedIncidents.passWithWarningFrames << ','
+			<< result.patternFailFrames << '\n';
+
+		failed += result.OverallResult == iris::AnalysisResult::Fail;
+		warnings += result.OverallResult == iris::AnalysisResult::PassWithWarning;
+	}
+
+	LOG_CORE_INFO("Analysed {} videos: {} failed, {} passed with warning, {} could not be analysed", summaries.size(), failed, warnings, errors);
+	LOG_CORE_INFO("Summary written to {}", summaryPath);
+}
+
 int main(int argc, char* argv[])
 {
 	iris::Log::Init(true, true);
@@ -94,6 +298,12 @@ int main(int argc, char* argv[])
 		sourceVideo = getCmdOption(argv, argv + argc, "-v");
 	}
 
+	unsigned int batchSize = 1;
+	if (cmdOptionExists(argv, argv + argc, "-b"))
+	{
+		batchSize = std::max(1, atoi(getCmdOption(argv, argv + argc, "-b")));
+	}
+
 	//load configuration
 	configuration.Init();
 
@@ -140,15 +350,35 @@ int main(int argc, char* argv[])
 	else
 	{
 		std::vector<std::string> videoFiles;
-		bool filesExist = GetVideoFiles(videoFiles);
-		if (filesExist)
+		bool filesExist;
+		if (cmdOptionExists(argv, argv + argc, "-l") || cmdOptionExists(argv, argv + argc, "-g"))
 		{
-			iris::VideoAnalyser vA(&configuration);
-
-			for (int i = 0; i < videoFiles.size(); ++i)
+			if (cmdOptionExists(argv, argv + argc, "-l"))
 			{
-				vA.AnalyseVideo(flagJson, videoFiles[i].c_str());
+				GetListFiles(getCmdOption(argv, argv + argc, "-l"), videoFiles);
 			}
+			if (cmdOptionExists(argv, argv + argc, "-g"))
+			{
+				GetGlobFiles(getCmdOption(argv, argv + argc, "-g"), videoFiles);
+			}
+			filesExist = !videoFiles.empty();
+		}
+		else
+		{
+			filesExist = GetVideoFiles(videoFiles);
+		}
+
+		if (filesExist)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			std::vector<VideoSummary> summaries;
+			AnalyseVideos(configuration, flagJson, videoFiles, batchSize, summaries);
+
+			auto end = std::chrono::steady_clock::now();
+			LOG_CORE_INFO("Batch analysis time: {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+
+			WriteSummary(configuration, summaries);
 		}
 	}
 	
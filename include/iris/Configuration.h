@@ -50,6 +50,79 @@ namespace iris
 		inline float GetFrameResizeProportion() { return m_frameResizeProportion; }
 		inline void SetFrameResizeProportion(float proportion) { m_frameResizeProportion = proportion; }
 
+		//number of decoded frames buffered ahead of the analysis, 0 decodes and analyses in the same thread
+		inline unsigned int GetDecodeQueueSize() { return m_decodeQueueSize; }
+		inline void SetDecodeQueueSize(unsigned int size) { m_decodeQueueSize = size; }
+
+		//decode the video with FFmpeg directly instead of cv::VideoCapture
+		inline bool FFmpegDecodingEnabled() { return m_ffmpegDecodingEnabled; }
+		inline void SetFFmpegDecodingEnabled(bool status) { m_ffmpegDecodingEnabled = status; }
+
+		//number of FFmpeg decoding threads, 0 lets FFmpeg choose
+		inline int GetDecoderThreads() { return m_decoderThreads; }
+		inline void SetDecoderThreads(int threads) { m_decoderThreads = threads; }
+
+		//analyse the decoded YUV frames directly (requires FFmpeg decoding, enabled automatically)
+		inline bool YuvAnalysisEnabled() { return m_yuvAnalysisEnabled; }
+		inline void SetYuvAnalysisEnabled(bool status) { m_yuvAnalysisEnabled = status; }
+
+		//number of chunks of the video analysed in parallel, 0 analyses the video sequentially. Needs FFmpeg decoding or YUV analysis, chunks decode with FFmpeg.
+		//Not used with the pattern gate, letterbox crop, duplicate frame detection or tile tracking
+		inline unsigned int GetAnalysisChunks() { return m_analysisChunks; }
+		inline void SetAnalysisChunks(unsigned int chunks) { m_analysisChunks = chunks; }
+
+		//run the photosensitivity detectors of a frame in parallel
+		inline bool ParallelDetectionEnabled() { return m_parallelDetectionEnabled; }
+		inline void SetParallelDetectionEnabled(bool status) { m_parallelDetectionEnabled = status; }
+
+		//convert BGR frames to luminance and red saturation in a single pass, without creating the sRGB frame
+		inline bool FusedConversionEnabled() { return m_fusedConversionEnabled; }
+		inline void SetFusedConversionEnabled(bool status) { m_fusedConversionEnabled = status; }
+
+		//compute the flash values in fixed point with exact frame means, results are reproducible across machines
+		inline bool FixedPointEnabled() { return m_fixedPointEnabled; }
+		inline void SetFixedPointEnabled(bool status) { m_fixedPointEnabled = status; }
+
+		//frames identical to the previous one are analysed with its results instead of being converted again
+		inline bool DuplicateFrameDetectionEnabled() { return m_duplicateFrameDetectionEnabled; }
+		inline void SetDuplicateFrameDetectionEnabled(bool status) { m_duplicateFrameDetectionEnabled = status; }
+
+		//convert only the tiles of BGR frames that changed from the previous frame and count the changed pixels of YUV frames only in the tiles that changed, also detects repeated frames
+		inline bool TileTrackingEnabled() { return m_tileTrackingEnabled; }
+		inline void SetTileTrackingEnabled(bool status) { m_tileTrackingEnabled = status; }
+
+		//no effect, decoder motion vectors cannot prove that a block is unchanged. Kept so existing settings files load, YUV tiles are compared with TileTrackingEnabled
+		inline bool DecoderChangeHintsEnabled() { return m_decoderChangeHintsEnabled; }
+		inline void SetDecoderChangeHintsEnabled(bool status) { m_decoderChangeHintsEnabled = status; }
+
+		//analyse only the area of BGR frames inside constant black borders (letterbox and pillarbox)
+		inline bool LetterboxCropEnabled() { return m_letterboxCropEnabled; }
+		inline void SetLetterboxCropEnabled(bool status) { m_letterboxCropEnabled = status; }
+
+		//[x, y, width, height] rectangles of the video frames that are not analysed, such as HUD overlays (BGR analysis)
+		inline const std::vector<std::vector<int>>& GetExclusionAreas() { return m_exclusionAreas; }
+		inline void SetExclusionAreas(const std::vector<std::vector<int>>& areas) { m_exclusionAreas = areas; }
+
+		//calculate red saturation on the 4:2:0 chroma grid instead of for every pixel (YUV analysis)
+		inline bool ChromaRedSaturationEnabled() { return m_chromaRedSaturationEnabled; }
+		inline void SetChromaRedSaturationEnabled(bool status) { m_chromaRedSaturationEnabled = status; }
+
+		//store the red saturation calculated from sRGB frames as runs of non zero values (without fused conversion)
+		inline bool SparseRedSaturationEnabled() { return m_sparseRedSaturationEnabled; }
+		inline void SetSparseRedSaturationEnabled(bool status) { m_sparseRedSaturationEnabled = status; }
+
+		//pattern detection reuses the last pattern while the mean absolute difference of the downscaled luminance (0-1 scaled to 0-255, before normalization) from the last analysed frame is below this, 0 to disable
+		inline float GetPatternGateThreshold() { return m_patternGateThreshold; }
+		inline void SetPatternGateThreshold(float threshold) { m_patternGateThreshold = threshold; }
+
+		//video analysis only, number of threads that detect patterns while the next frames are analysed, results are committed in frame order, 0 to disable
+		inline unsigned int GetPatternWorkers() { return m_patternWorkers; }
+		inline void SetPatternWorkers(unsigned int workers) { m_patternWorkers = workers; }
+
+		//real time only, frames whose luminance and red channel means differ less than this from the last analysed frame are not converted, 0 to disable
+		inline float GetRealTimeSkipThreshold() { return m_realTimeSkipThreshold; }
+		inline void SetRealTimeSkipThreshold(float threshold) { m_realTimeSkipThreshold = threshold; }
+
 		void SetRedSaturationFlashThreshold(float newFlashThreshold);
 		void SetRedSaturationDarkThreshold(float newDarkThreshold);
 
@@ -76,6 +149,25 @@ namespace iris
 		float m_frameResizeProportion = 1;
 		bool m_analyseByTime = false;
 
+		unsigned int m_decodeQueueSize = 0;
+		bool m_ffmpegDecodingEnabled = false;
+		int m_decoderThreads = 0;
+		bool m_yuvAnalysisEnabled = false;
+		unsigned int m_analysisChunks = 0;
+		bool m_parallelDetectionEnabled = false;
+		bool m_fusedConversionEnabled = false;
+		bool m_fixedPointEnabled = false;
+		bool m_duplicateFrameDetectionEnabled = false;
+		bool m_tileTrackingEnabled = false;
+		bool m_decoderChangeHintsEnabled = false;
+		bool m_letterboxCropEnabled = false;
+		std::vector<std::vector<int>> m_exclusionAreas;
+		bool m_chromaRedSaturationEnabled = false;
+		bool m_sparseRedSaturationEnabled = false;
+		float m_patternGateThreshold = 0;
+		unsigned int m_patternWorkers = 0;
+		float m_realTimeSkipThreshold = 0;
+
 		std::string m_resultsPath;
 	};
 }
@@ -36,6 +36,13 @@ namespace iris
 		/// <param name="fileName">file name and path to log.csv file</param>
 		static void SetDataLoggerFile(const char* fileName);
 
+		/// <summary>
+		/// Creates a new data logger that persists the frame data to its own file, used when several
+		/// videos are analysed at the same time
+		/// </summary>
+		/// <param name="fileName">file name and path to log.csv file</param>
+		static std::shared_ptr<spdlog::logger> CreateDataLogger(const char* fileName);
+
 		inline static std::shared_ptr<spdlog::logger>& GetDataLogger() { return m_DataLogger; }
 
 	private:
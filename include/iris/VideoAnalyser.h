@@ -18,6 +18,12 @@
 
 #pragma once
 #include <opencv2/core/types.hpp>
+#include <memory>
+
+namespace spdlog
+{
+	class logger;
+}
 
 namespace cv
 {
@@ -36,8 +42,22 @@ namespace iris
 	class FlashDetection;
 	class PatternDetection;
 	class PhotosensitivityDetector;
+	struct IrisFrame;
 	class FrameData;
 	class IFrameManager;
+	class IFrameSource;
+	class FFmpegFrameSource;
+	class YuvFrameConverter;
+	class BgrFrameConverter;
+	class ThreadPool;
+	class FrameBufferPool;
+	class FrameHistogram;
+	class FrameChangeTracker;
+	class LetterboxDetector;
+	struct FrameTiles;
+	struct ExclusionMask;
+	struct YuvFrame;
+	struct AnalysisChunk;
 	struct FrameDataJson;
 	struct Result;
 
@@ -50,7 +70,8 @@ namespace iris
 		/// <summary>
 		/// Initializes FlashDetection and PatternDetection
 		/// </summary>
-		void Init(const std::string& videoName, bool flagJson = false);
+		/// <param name="resultsName"> results directory in the results path, the video file name if empty</param>
+		void Init(const std::string& videoName, bool flagJson = false, const std::string& resultsName = "");
 
 		/// <summary>
 		/// Real time use Only - Initializes FlashDetection and PatternDection
@@ -72,7 +93,9 @@ namespace iris
 		/// </summary>
 		/// <param name="flagJson"> If true, saves Result to json file</param>
 		/// <param name="sourceVideo"> video file path</param>
-		void AnalyseVideo(bool flagJson, const char* sourceVideo);
+		/// <param name="result"> if not null, receives the Result of the video analysis</param>
+		/// <param name="resultsName"> results directory in the results path, the video file name if null</param>
+		void AnalyseVideo(bool flagJson, const char* sourceVideo, Result* result = nullptr, const char* resultsName = nullptr);
 
 		/// <summary>
 		/// Frame analysis for checking for photosensitivity for tracked issues (flashes/patterns)
@@ -84,6 +107,12 @@ namespace iris
 		/// </summary>
 		void SetOptimalCvThreads(cv::Size size);
 
+		/// <summary>
+		/// Sets whether AnalyseVideo sets the optimal number of threads for each video. The OpenCV threads are shared
+		/// by the process, analysers that run at the same time disable it and the number of threads is set once
+		/// </summary>
+		inline void SetOptimalCvThreadsEnabled(bool enabled) { m_optimalCvThreads = enabled; }
+
 		
 		struct VideoInfo
 		{
@@ -100,6 +129,16 @@ namespace iris
 		[[nodiscard]] inline std::string GetFrameDataPath() const {return m_frameDataPath;};
 	private:
 
+		/// <summary>
+		/// Chunk analyser, uses the video information of the analyser that owns the chunk and does not log
+		/// </summary>
+		VideoAnalyser(Configuration* configuration, const VideoInfo& videoInfo);
+
+		/// <summary>
+		/// Creates the frame converters and the photosensitivity detectors for the current video information
+		/// </summary>
+		void InitDetectors();
+
 		/// <summary>
 		/// Obtains the avg_frame_rate of the video
 		/// </summary>
@@ -107,6 +146,67 @@ namespace iris
 		/// <returns>frames per second in video</returns>
 		int GetVideoFps(const char* sourceVideo);
 
+		/// <summary>
+		/// Opens the video with the decoder selected in the configuration and obtains the video information
+		/// </summary>
+		/// <returns>frame source owned by the caller to read the video frames from, throws if the video cannot be opened</returns>
+		std::unique_ptr<IFrameSource> OpenFrameSource(const char* sourceVideo);
+
+		/// <summary>
+		/// Reads the next video frame and resizes it if frame resize is enabled
+		/// </summary>
+		/// <returns>false if there are no more frames to read</returns>
+		bool ReadFrame(IFrameSource& video, cv::Mat& frame);
+		bool ReadFrame(FFmpegFrameSource& video, YuvFrame& frame);
+
+		/// <summary>
+		/// Frame analysis from the decoded YUV planes, the frame is never converted to BGR or sRGB
+		/// </summary>
+		void AnalyseFrame(YuvFrame& frame, unsigned int& frameIndex, FrameData& data);
+
+		/// <summary>
+		/// Analyses a frame whose flash values are the ones of the last analysed frame
+		/// </summary>
+		void AnalyseRepeatedFrame(const cv::Mat* frame, unsigned int& frameIndex, FrameData& data);
+
+		/// <summary>
+		/// Real time only, checks if the luminance and red channel means of the frame are within the skip threshold of
+		/// the last analysed frame, if they are not the frame becomes the last analysed frame
+		/// </summary>
+		/// <returns>true if the frame can be analysed as a repeat of the last analysed frame</returns>
+		bool RepeatsAnalysedFrame(const cv::Mat& frame, unsigned int frameIndex);
+
+		/// <summary>
+		/// Updates the letterbox content area with the video frame, the detectors are set to the new area if it changed
+		/// </summary>
+		/// <returns>area of the video frame to analyse</returns>
+		const cv::Rect& UpdateFrameArea(const cv::Mat& frame);
+
+		/// <summary>
+		/// Runs the photosensitivity detectors on the frame, in parallel if enabled in the configuration
+		/// </summary>
+		void CheckFrame(const IrisFrame& irisFrame, unsigned int& frameIndex, FrameData& data);
+
+		/// <summary>
+		/// Splits the video in chunks that are analysed in parallel and merges the resulting frame data in order.
+		/// Each chunk starts decoding a warm-up window ahead of its first frame so the detectors reach the same
+		/// state as in a sequential analysis
+		/// </summary>
+		/// <returns>false if the video is too short to be split in chunks</returns>
+		bool AnalyseChunks(const char* sourceVideo, std::vector<FrameData>& frames);
+
+		/// <summary>
+		/// Analyses the chunk frames with a new set of detectors
+		/// </summary>
+		void AnalyseChunk(const char* sourceVideo, AnalysisChunk& chunk);
+
+		/// <summary>
+		/// Obtains the video Result from the frame data of the whole video
+		/// </summary>
+		void SetResult(const std::vector<FrameData>& frames, Result& result);
+
+		void LogVideoInfo(const char* sourceVideo);
+
 		void SerializeResults(const Result& result, const FrameDataJson& lineGraphData, const FrameDataJson& nonPassData);
 
 		/// <summary>
@@ -115,15 +215,31 @@ namespace iris
 		void UpdateProgress(unsigned int& numFrames, const unsigned long& totalFrames, unsigned int& lastPercentage);
 
 		Configuration* m_configuration = nullptr;
+		bool m_optimalCvThreads = true; //AnalyseVideo sets the optimal number of OpenCV threads for the video
 		FlashDetection* m_flashDetection = nullptr;
 		PatternDetection* m_patternDetection = nullptr;
 		std::vector<PhotosensitivityDetector*> m_photosensitivityDetector;
+		ThreadPool* m_detectorPool = nullptr; //runs all but one of the detectors when parallel detection is enabled
+		FrameBufferPool* m_framePool = nullptr; //recycled sRGB, luminance and red saturation frames
+		FrameChangeTracker* m_frameChangeTracker = nullptr; //detects exact repeats of the last decoded frame
+		FrameTiles* m_frameTiles = nullptr; //tiles of the current BGR frame that changed, when tile tracking is enabled
+		LetterboxDetector* m_letterboxDetector = nullptr; //content area of BGR frames, when letterbox crop is enabled
+		cv::Rect m_frameArea; //area of the video frames that is analysed
+		float m_frameAreaProportion = 1; //analysed area / video frame area
+		std::vector<cv::Rect> m_exclusionAreas; //rectangles of the video frames that are not analysed
+		ExclusionMask* m_exclusionMask = nullptr; //analysed pixels of the frame area, when there are exclusion areas
+		FrameHistogram* m_frameHistogram = nullptr; //real time skip threshold, channel histograms of the current frame
+		float m_analysedLuminanceMean = 0; //luminance mean of the last frame whose flash values were calculated
+		float m_analysedRedMean = 0; //red channel mean of the last frame whose flash values were calculated
 
 		EA::EACC::Utils::FrameConverter* m_frameSrgbConverter = nullptr;
+		YuvFrameConverter* m_yuvFrameConverter = nullptr;
+		BgrFrameConverter* m_bgrFrameConverter = nullptr;
 
 		std::string m_resultJsonPath;
 		std::string m_frameDataJsonPath;
 		std::string m_frameDataPath;
+		std::shared_ptr<spdlog::logger> m_dataLogger; //frame data file of the analysed video
 
 		IFrameManager* m_frameManager = nullptr;
 		VideoInfo m_videoInfo;
@@ -0,0 +1,177 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include "BgrFrameConverter.h"
+#include "utils/FrameConverter.h"
+#include <opencv2/core.hpp>
+#include <algorithm>
+
+namespace iris
+{
+	BgrFrameConverter::BgrFrameConverter(EA::EACC::Utils::FrameConverterParams* params)
+		: m_sRgbValues(params->values), m_fixedTables(params->values)
+	{
+		m_blueLuminance.resize(m_sRgbValues.size());
+		m_greenLuminance.resize(m_sRgbValues.size());
+		m_redLuminance.resize(m_sRgbValues.size());
+
+		//Y = 0.0722 * B + 0.7152 * G + 0.2126 * R, same products as RelativeLuminance
+		for (size_t i = 0; i < m_sRgbValues.size(); i++)
+		{
+			m_blueLuminance[i] = 0.0722f * m_sRgbValues[i];
+			m_greenLuminance[i] = 0.7152f * m_sRgbValues[i];
+			m_redLuminance[i] = 0.2126f * m_sRgbValues[i];
+		}
+	}
+
+	namespace
+	{
+		/// <summary>
+		/// Converts the changed tiles of the frame with convertPixel and copies the rest from the last values.
+		/// Each tile sum is added in row order and the tile sums in tile order, so the means are the same
+		/// whichever tiles are converted and do not depend on the thread split. Excluded pixels are set to 0,
+		/// which does not change the sums
+		/// </summary>
+		template <typename Value, typename Sum, typename ConvertPixel>
+		void ConvertTiles(const cv::Mat& frame, const FrameTiles& tiles, const ExclusionMask* mask, const cv::Mat* lastLuminance, const cv::Mat* lastRedSaturation,
+			cv::Mat& luminance, cv::Mat& redSaturation, std::vector<Sum>& luminanceTileSums, std::vector<Sum>& redSaturationTileSums,
+			Sum& luminanceTotal, Sum& redSaturationTotal, ConvertPixel convertPixel)
+		{
+			if (mask != nullptr && mask->frameSize != frame.size())
+			{
+				mask = nullptr;
+			}
+
+			//the last values can only be used if they are the previous conversion of a frame of the same size
+			const int type = cv::DataType<Value>::type;
+			const bool allChanged = lastLuminance == nullptr || lastLuminance->size() != frame.size() || lastLuminance->type() != type
+				|| lastRedSaturation->size() != frame.size() || lastRedSaturation->type() != type || (int)luminanceTileSums.size() != tiles.Count();
+
+			luminance.create(frame.size(), type);
+			redSaturation.create(frame.size(), type);
+			luminanceTileSums.resize(tiles.Count());
+			redSaturationTileSums.resize(tiles.Count());
+
+			cv::parallel_for_(cv::Range(0, tiles.Count()), [&](const cv::Range& range)
+			{
+				for (int tile = range.start; tile < range.end; tile++)
+				{
+					const cv::Rect area = tiles.Tile(tile);
+					if (!allChanged && !tiles.changed[tile])
+					{
+						//same source pixels, same values and sums
+						cv::Mat luminanceTile = luminance(area), redSaturationTile = redSaturation(area);
+						(*lastLuminance)(area).copyTo(luminanceTile);
+						(*lastRedSaturation)(area).copyTo(redSaturationTile);
+						continue;
+					}
+
+					Sum lumSum = 0, redSum = 0;
+					for (int row = area.y; row < area.y + area.height; row++)
+					{
+						const uchar* bgrRow = frame.ptr<uchar>(row);
+						Value* lumRow = luminance.ptr<Value>(row);
+						Value* redRow = redSaturation.ptr<Value>(row);
+
+						auto convertSpan = [&](int begin, int end)
+						{
+							for (int col = begin; col < end; col++)
+							{
+								convertPixel(bgrRow + col * 3, lumRow[col], redRow[col]);
+								lumSum += lumRow[col];
+								redSum += redRow[col];
+							}
+						};
+
+						if (mask == nullptr)
+						{
+							convertSpan(area.x, area.x + area.width);
+							continue;
+						}
+						std::fill(lumRow + area.x, lumRow + area.x + area.width, Value(0));
+						std::fill(redRow + area.x, redRow + area.x + area.width, Value(0));
+						mask->ForEachSpan(row, area.x, area.x + area.width, convertSpan);
+					}
+					luminanceTileSums[tile] = lumSum;
+					redSaturationTileSums[tile] = redSum;
+				}
+			});
+
+			luminanceTotal = 0;
+			redSaturationTotal = 0;
+			for (int tile = 0; tile < tiles.Count(); tile++)
+			{
+				luminanceTotal += luminanceTileSums[tile];
+				redSaturationTotal += redSaturationTileSums[tile];
+			}
+		}
+	}
+
+	void BgrFrameConverter::Convert(const cv::Mat& frame, cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean)
+	{
+		if (m_allTiles.frameSize != frame.size())
+		{
+			m_allTiles = FrameTiles(frame.size());
+		}
+		Convert(frame, m_allTiles, nullptr, nullptr, luminance, redSaturation, luminanceMean, redSaturationMean);
+	}
+
+	void BgrFrameConverter::Convert(const cv::Mat& frame, const FrameTiles& tiles, const cv::Mat* lastLuminance, const cv::Mat* lastRedSaturation,
+		cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean)
+	{
+		const float* sRgb = m_sRgbValues.data();
+		const float* blueLum = m_blueLuminance.data();
+		const float* greenLum = m_greenLuminance.data();
+		const float* redLum = m_redLuminance.data();
+
+		double lumTotal, redTotal;
+		ConvertTiles<float>(frame, tiles, m_exclusionMask, lastLuminance, lastRedSaturation, luminance, redSaturation,
+			m_luminanceTileSums, m_redSaturationTileSums, lumTotal, redTotal, [&](const uchar* bgr, float& lum, float& red)
+		{
+			lum = blueLum[bgr[0]] + greenLum[bgr[1]] + redLum[bgr[2]];
+
+			//if R / (R + G + B) >= 0.8 => pixel is saturated red, value is (R - G - B) * 320 (negative values set to 0)
+			const float b = sRgb[bgr[0]];
+			const float g = sRgb[bgr[1]];
+			const float r = sRgb[bgr[2]];
+			red = 0;
+			if (r / (r + g + b) >= 0.8f)
+			{
+				red = (r - g - b) * 320;
+				red = red > 0 ? red : 0;
+			}
+		});
+
+		const double pixels = (double)frame.total();
+		luminanceMean = pixels > 0 ? lumTotal / pixels : 0;
+		redSaturationMean = pixels > 0 ? redTotal / pixels : 0;
+	}
+
+	void BgrFrameConverter::ConvertFixed(const cv::Mat& frame, cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean)
+	{
+		if (m_allTiles.frameSize != frame.size())
+		{
+			m_allTiles = FrameTiles(frame.size());
+		}
+		ConvertFixed(frame, m_allTiles, nullptr, nullptr, luminance, redSaturation, luminanceMean, redSaturationMean);
+	}
+
+	void BgrFrameConverter::ConvertFixed(const cv::Mat& frame, const FrameTiles& tiles, const cv::Mat* lastLuminance, const cv::Mat* lastRedSaturation,
+		cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean)
+	{
+		const int* sRgb = m_fixedTables.sRgb.data();
+		const int* blueLum = m_fixedTables.blueLuminance.data();
+		const int* greenLum = m_fixedTables.greenLuminance.data();
+		const int* redLum = m_fixedTables.redLuminance.data();
+
+		long long lumTotal, redTotal;
+		ConvertTiles<int>(frame, tiles, m_exclusionMask, lastLuminance, lastRedSaturation, luminance, redSaturation,
+			m_luminanceFixedTileSums, m_redSaturationFixedTileSums, lumTotal, redTotal, [&](const uchar* bgr, int& lum, int& red)
+		{
+			lum = blueLum[bgr[0]] + greenLum[bgr[1]] + redLum[bgr[2]];
+			red = FixedPoint::RedSaturation(sRgb[bgr[2]], sRgb[bgr[1]], sRgb[bgr[0]]);
+		});
+
+		luminanceMean = FixedPoint::ToMean(lumTotal, frame.total());
+		redSaturationMean = FixedPoint::ToMean(redTotal, frame.total());
+	}
+}
@@ -0,0 +1,99 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Converts 8 bit BGR frames straight into the flash detection values.
+// Each row of the frame is read once: the pixels are linearized with the
+// sRGB look up table, reduced to their relative luminance and red
+// saturation and added to the frame means in the same pass, so the
+// CV_32FC3 sRGB frame is never created and the outputs are not read again
+// to obtain their means. The frame is converted by tiles, when the tiles
+// that changed from the last frame are known only those are converted.
+// Pixels of the exclusion mask are not converted and set to 0.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+#include "FixedPoint.h"
+#include "FrameTiles.h"
+#include "ExclusionMask.h"
+
+namespace cv
+{
+	class Mat;
+}
+
+namespace EA::EACC::Utils
+{
+	struct FrameConverterParams;
+}
+
+namespace iris
+{
+	class BgrFrameConverter
+	{
+	public:
+		/// <param name="params">sRGB look up table values, same as the ones used by FrameConverter</param>
+		BgrFrameConverter(EA::EACC::Utils::FrameConverterParams* params);
+
+		/// <summary>
+		/// Calculates the relative luminance and red saturation values of a BGR frame and their frame means
+		/// </summary>
+		/// <param name="frame">video frame (CV_8UC3)</param>
+		/// <param name="luminance">output relative luminance values (CV_32FC1)</param>
+		/// <param name="redSaturation">output red saturation values (CV_32FC1)</param>
+		/// <param name="luminanceMean">output mean of the relative luminance values</param>
+		/// <param name="redSaturationMean">output mean of the red saturation values</param>
+		void Convert(const cv::Mat& frame, cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean);
+
+		/// <summary>
+		/// Same as Convert, only the changed tiles are converted and the rest are copied from the last values.
+		/// The last values must be the ones of the previous conversion, otherwise every tile is converted
+		/// </summary>
+		/// <param name="tiles">tiles of the frame that changed from the previous converted frame</param>
+		/// <param name="lastLuminance">relative luminance values of the previous converted frame, null to convert every tile</param>
+		/// <param name="lastRedSaturation">red saturation values of the previous converted frame</param>
+		void Convert(const cv::Mat& frame, const FrameTiles& tiles, const cv::Mat* lastLuminance, const cv::Mat* lastRedSaturation,
+			cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean);
+
+		/// <summary>
+		/// Calculates the fixed point relative luminance and red saturation values of a BGR frame and their exact frame means
+		/// </summary>
+		/// <param name="frame">video frame (CV_8UC3)</param>
+		/// <param name="luminance">output Q16 relative luminance values (CV_32SC1)</param>
+		/// <param name="redSaturation">output Q16 red saturation values (CV_32SC1)</param>
+		/// <param name="luminanceMean">output mean of the relative luminance values</param>
+		/// <param name="redSaturationMean">output mean of the red saturation values</param>
+		void ConvertFixed(const cv::Mat& frame, cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean);
+
+		/// <summary>
+		/// Same as ConvertFixed, only the changed tiles are converted and the rest are copied from the last values
+		/// </summary>
+		void ConvertFixed(const cv::Mat& frame, const FrameTiles& tiles, const cv::Mat* lastLuminance, const cv::Mat* lastRedSaturation,
+			cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean);
+
+		/// <summary>
+		/// Sets the areas of the frames that are not converted, the mask is only used for frames of its size
+		/// </summary>
+		/// <param name="mask">mask that outlives the converter, null to convert every pixel</param>
+		inline void SetExclusionMask(const ExclusionMask* mask) { m_exclusionMask = mask; }
+
+	private:
+		std::vector<float> m_sRgbValues; //8 bit to linear sRGB look up table
+
+		//sRGB values already multiplied by the luminance coefficient of each channel
+		std::vector<float> m_blueLuminance;
+		std::vector<float> m_greenLuminance;
+		std::vector<float> m_redLuminance;
+
+		const ExclusionMask* m_exclusionMask = nullptr;
+		FrameTiles m_allTiles; //every tile changed, used when the changed tiles are not known
+
+		//sums of the output tiles of the last conversion, unchanged tiles keep their sums
+		std::vector<double> m_luminanceTileSums;
+		std::vector<double> m_redSaturationTileSums;
+
+		FixedPoint::FlashTables m_fixedTables;
+		std::vector<long long> m_luminanceFixedTileSums;
+		std::vector<long long> m_redSaturationFixedTileSums;
+	};
+}
@@ -54,6 +54,96 @@ namespace iris
 
 		m_frameResizeProportion = jsonFile.GetParam<float>("VideoAnalyser", "ResizeFrameProportion");
 
+		if (jsonFile.ContainsParam("VideoAnalyser", "DecodeQueueSize"))
+		{
+			m_decodeQueueSize = jsonFile.GetParam<uint>("VideoAnalyser", "DecodeQueueSize");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "FFmpegDecodingEnabled"))
+		{
+			m_ffmpegDecodingEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "FFmpegDecodingEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "DecoderThreads"))
+		{
+			m_decoderThreads = jsonFile.GetParam<int>("VideoAnalyser", "DecoderThreads");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "YuvAnalysisEnabled"))
+		{
+			m_yuvAnalysisEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "YuvAnalysisEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "AnalysisChunks"))
+		{
+			m_analysisChunks = jsonFile.GetParam<uint>("VideoAnalyser", "AnalysisChunks");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "ParallelDetectionEnabled"))
+		{
+			m_parallelDetectionEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "ParallelDetectionEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "FusedConversionEnabled"))
+		{
+			m_fusedConversionEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "FusedConversionEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "FixedPointEnabled"))
+		{
+			m_fixedPointEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "FixedPointEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "DuplicateFrameDetectionEnabled"))
+		{
+			m_duplicateFrameDetectionEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "DuplicateFrameDetectionEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "TileTrackingEnabled"))
+		{
+			m_tileTrackingEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "TileTrackingEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "DecoderChangeHintsEnabled"))
+		{
+			m_decoderChangeHintsEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "DecoderChangeHintsEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "LetterboxCropEnabled"))
+		{
+			m_letterboxCropEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "LetterboxCropEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "ExclusionAreas"))
+		{
+			m_exclusionAreas = jsonFile.GetVector<std::vector<int>>("VideoAnalyser", "ExclusionAreas");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "ChromaRedSaturationEnabled"))
+		{
+			m_chromaRedSaturationEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "ChromaRedSaturationEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "SparseRedSaturationEnabled"))
+		{
+			m_sparseRedSaturationEnabled = jsonFile.GetParam<bool>("VideoAnalyser", "SparseRedSaturationEnabled");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "PatternGateThreshold"))
+		{
+			m_patternGateThreshold = jsonFile.GetParam<float>("VideoAnalyser", "PatternGateThreshold");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "PatternWorkers"))
+		{
+			m_patternWorkers = jsonFile.GetParam<uint>("VideoAnalyser", "PatternWorkers");
+		}
+
+		if (jsonFile.ContainsParam("VideoAnalyser", "RealTimeSkipThreshold"))
+		{
+			m_realTimeSkipThreshold = jsonFile.GetParam<float>("VideoAnalyser", "RealTimeSkipThreshold");
+		}
+
 		m_luminanceFlashParams = new FlashParams(
 			jsonFile.GetParam<float>("Luminance", "RelativeLuminanceFlashThreshold"), 
 			jsonFile.GetParam<float>("FlashDetection", "AreaProportion"), 
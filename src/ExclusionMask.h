@@ -0,0 +1,82 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Areas of the frame that are not analysed, such as fixed HUD or UI
+// overlays that are reviewed separately. The excluded rectangles are
+// stored as the spans of analysed columns of each row, so the conversion
+// and the changed pixel count only visit the analysed pixels. Excluded
+// pixels have no flash values, the frame means and the safe areas are
+// still relative to the full frame.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace iris
+{
+
+struct ExclusionMask
+{
+	ExclusionMask() {};
+
+	/// <param name="frameSize">size of the masked frames</param>
+	/// <param name="areas">excluded rectangles, the parts outside the frame are ignored</param>
+	ExclusionMask(const cv::Size& frameSize, const std::vector<cv::Rect>& areas) : frameSize(frameSize), spans(frameSize.height)
+	{
+		const cv::Rect frameRect(cv::Point(0, 0), frameSize);
+		std::vector<cv::Range> excluded;
+		for (int row = 0; row < frameSize.height; row++)
+		{
+			excluded.clear();
+			for (const cv::Rect& area : areas)
+			{
+				const cv::Rect clipped = area & frameRect;
+				if (!clipped.empty() && row >= clipped.y && row < clipped.y + clipped.height)
+				{
+					excluded.emplace_back(clipped.x, clipped.x + clipped.width);
+				}
+			}
+			std::sort(excluded.begin(), excluded.end(), [](const cv::Range& a, const cv::Range& b) { return a.start < b.start; });
+
+			//analysed columns between the excluded ranges
+			int col = 0;
+			for (const cv::Range& range : excluded)
+			{
+				if (range.start > col)
+				{
+					spans[row].emplace_back(col, range.start);
+				}
+				excludedPixels += std::max(0, range.end - std::max(col, range.start));
+				col = std::max(col, range.end);
+			}
+			if (col < frameSize.width)
+			{
+				spans[row].emplace_back(col, frameSize.width);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Calls analyseSpan(begin, end) for every span of analysed columns of the row between the begin and end columns
+	/// </summary>
+	template <typename AnalyseSpan>
+	void ForEachSpan(int row, int begin, int end, AnalyseSpan analyseSpan) const
+	{
+		for (const cv::Range& span : spans[row])
+		{
+			const int spanBegin = std::max(begin, span.start), spanEnd = std::min(end, span.end);
+			if (spanBegin < spanEnd)
+			{
+				analyseSpan(spanBegin, spanEnd);
+			}
+		}
+	}
+
+	cv::Size frameSize;
+	std::vector<std::vector<cv::Range>> spans; //analysed columns of each row
+	int excludedPixels = 0;
+};
+
+}
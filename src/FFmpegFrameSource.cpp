@@ -0,0 +1,386 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+#include "FFmpegFrameSource.h"
+#include "YuvFrame.h"
+#include <opencv2/core.hpp>
+#include "iris/Log.h"
+#include <cmath>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace iris
+{
+
+FFmpegFrameSource::FFmpegFrameSource(int decoderThreads) : m_decoderThreads(decoderThreads)
+{
+}
+
+FFmpegFrameSource::~FFmpegFrameSource()
+{
+	Release();
+}
+
+bool FFmpegFrameSource::Open(const char* sourceVideo, float outputScale)
+{
+	if (avformat_open_input(&m_formatContext, sourceVideo, NULL, NULL) != 0)
+	{
+		LOG_CORE_ERROR("Unable to open file {}", sourceVideo);
+		return false;
+	}
+
+	if (avformat_find_stream_info(m_formatContext, NULL) < 0)
+	{
+		LOG_CORE_ERROR("Failed to retrieve stream info");
+		Release();
+		return false;
+	}
+
+	const AVCodec* codec = nullptr;
+	m_videoStreamIndex = av_find_best_stream(m_formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+	if (m_videoStreamIndex < 0 || codec == nullptr)
+	{
+		LOG_CORE_ERROR("No decodable video stream found");
+		Release();
+		return false;
+	}
+
+	//demuxer drops the packets of every other stream (audio, subtitles, data)
+	for (unsigned int i = 0; i < m_formatContext->nb_streams; i++)
+	{
+		if ((int)i != m_videoStreamIndex)
+		{
+			m_formatContext->streams[i]->discard = AVDISCARD_ALL;
+		}
+	}
+
+	AVStream* stream = m_formatContext->streams[m_videoStreamIndex];
+
+	m_codecContext = avcodec_alloc_context3(codec);
+	if (m_codecContext == nullptr || avcodec_parameters_to_context(m_codecContext, stream->codecpar) < 0)
+	{
+		LOG_CORE_ERROR("Failed to initialize the {} decoder", codec->name);
+		Release();
+		return false;
+	}
+
+	m_codecContext->thread_count = m_decoderThreads;
+	m_codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
+	//same truncation as the frame resize done by VideoAnalyser::Init
+	m_frameSize = cv::Size(stream->codecpar->width, stream->codecpar->height);
+	m_outputSize = outputScale < 1.0f
+		? cv::Size(m_frameSize.width * outputScale, m_frameSize.height * outputScale)
+		: m_frameSize;
+
+	//decode directly at 1/2, 1/4 or 1/8 of the resolution if the codec supports it and the output is not bigger
+	int lowres = 0;
+	while (lowres < codec->max_lowres && outputScale * (2 << lowres) <= 1.0f)
+	{
+		lowres++;
+	}
+	m_codecContext->lowres = lowres;
+
+	if (avcodec_open2(m_codecContext, codec, NULL) < 0)
+	{
+		LOG_CORE_ERROR("Failed to open the {} decoder", codec->name);
+		Release();
+		return false;
+	}
+
+	m_packet = av_packet_alloc();
+	m_frame = av_frame_alloc();
+
+	//frame indices can only be derived from the timestamps when all frames have the same duration
+	m_constantFrameRate = stream->avg_frame_rate.num != 0
+		&& (int64_t)stream->avg_frame_rate.num * stream->r_frame_rate.den == (int64_t)stream->r_frame_rate.num * stream->avg_frame_rate.den;
+
+	//same video information as the one obtained with VideoAnalyser::GetVideoFps and cv::VideoCapture
+	AVRational avgFrameRate = stream->avg_frame_rate;
+	m_fps = avgFrameRate.den != 0 ? round(avgFrameRate.num / (float)avgFrameRate.den) : 0;
+
+	if (stream->nb_frames > 0)
+	{
+		m_frameCount = stream->nb_frames;
+	}
+	else
+	{
+		double duration = stream->duration != AV_NOPTS_VALUE
+			? stream->duration * av_q2d(stream->time_base)
+			: m_formatContext->duration / (double)AV_TIME_BASE;
+		m_frameCount = floor(duration * av_q2d(avgFrameRate) + 0.5);
+	}
+
+	LOG_CORE_DEBUG("FFmpeg decoder: {0}, threads: {1}, lowres: {2}", codec->name, m_codecContext->thread_count, lowres);
+	return true;
+}
+
+bool FFmpegFrameSource::Read(cv::Mat& frame)
+{
+	if (m_codecContext == nullptr || !DecodeFrame())
+	{
+		return false;
+	}
+
+	//convert the decoded frame to BGR, the same output format cv::VideoCapture produces,
+	//and downscale it in the same pass so the full resolution BGR frame is never created
+	m_swsContext = sws_getCachedContext(m_swsContext,
+		m_frame->width, m_frame->height, (AVPixelFormat)m_frame->format,
+		m_outputSize.width, m_outputSize.height, AV_PIX_FMT_BGR24,
+		GetScaleFlags(), NULL, NULL, NULL);
+
+	if (m_swsContext == nullptr)
+	{
+		LOG_CORE_ERROR("Failed to convert decoded frame to BGR");
+		av_frame_unref(m_frame);
+		return false;
+	}
+
+	frame.create(m_outputSize, CV_8UC3);
+	uint8_t* dstData[] = { frame.data };
+	int dstLinesize[] = { (int)frame.step };
+	sws_scale(m_swsContext, m_frame->data, m_frame->linesize, 0, m_frame->height, dstData, dstLinesize);
+
+	av_frame_unref(m_frame);
+	return true;
+}
+
+bool FFmpegFrameSource::Read(YuvFrame& frame)
+{
+	if (m_codecContext == nullptr || !DecodeFrame())
+	{
+		return false;
+	}
+
+	const int width = m_frame->width;
+	const int height = m_frame->height;
+	const cv::Size chromaSize((width + 1) / 2, (height + 1) / 2);
+	const AVPixelFormat format = (AVPixelFormat)m_frame->format;
+	const bool scaled = width != m_outputSize.width || height != m_outputSize.height;
+
+	frame.fullRange = m_frame->color_range == AVCOL_RANGE_JPEG || format == AV_PIX_FMT_YUVJ420P;
+	frame.bt709 = m_frame->colorspace == AVCOL_SPC_BT709;
+
+	//planes are copied as the decoder reuses its buffers for the next frames
+	if (format == AV_PIX_FMT_NV12 && !scaled)
+	{
+		frame.layout = YuvFrame::Layout::NV12;
+		cv::Mat(height, width, CV_8UC1, m_frame->data[0], m_frame->linesize[0]).copyTo(frame.y);
+		cv::Mat(chromaSize, CV_8UC2, m_frame->data[1], m_frame->linesize[1]).copyTo(frame.u);
+		frame.v.release();
+	}
+	else if ((format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P) && !scaled)
+	{
+		frame.layout = YuvFrame::Layout::I420;
+		cv::Mat(height, width, CV_8UC1, m_frame->data[0], m_frame->linesize[0]).copyTo(frame.y);
+		cv::Mat(chromaSize, CV_8UC1, m_frame->data[1], m_frame->linesize[1]).copyTo(frame.u);
+		cv::Mat(chromaSize, CV_8UC1, m_frame->data[2], m_frame->linesize[2]).copyTo(frame.v);
+	}
+	else
+	{
+		//4:2:2, 4:4:4, high bit depth or RGB formats are converted to 8 bit I420, downscaled frames are resized in the same pass
+		m_yuvSwsContext = sws_getCachedContext(m_yuvSwsContext,
+			width, height, format, m_outputSize.width, m_outputSize.height, AV_PIX_FMT_YUV420P,
+			GetScaleFlags(), NULL, NULL, NULL);
+
+		if (m_yuvSwsContext == nullptr)
+		{
+			LOG_CORE_ERROR("Failed to convert decoded frame to YUV 4:2:0");
+			av_frame_unref(m_frame);
+			return false;
+		}
+
+		const AVPixFmtDescriptor* descriptor = av_pix_fmt_desc_get(format);
+		if (descriptor != nullptr && (descriptor->flags & AV_PIX_FMT_FLAG_RGB))
+		{
+			frame.fullRange = false;
+			frame.bt709 = false;
+		}
+
+		//keep the source range and color matrix, only the chroma subsampling and bit depth change
+		const int* coefficients = sws_getCoefficients(frame.bt709 ? SWS_CS_ITU709 : SWS_CS_ITU601);
+		sws_setColorspaceDetails(m_yuvSwsContext, coefficients, frame.fullRange, coefficients, frame.fullRange, 0, 1 << 16, 1 << 16);
+
+		const cv::Size outputChromaSize((m_outputSize.width + 1) / 2, (m_outputSize.height + 1) / 2);
+		frame.layout = YuvFrame::Layout::I420;
+		frame.y.create(m_outputSize, CV_8UC1);
+		frame.u.create(outputChromaSize, CV_8UC1);
+		frame.v.create(outputChromaSize, CV_8UC1);
+
+		uint8_t* dstData[] = { frame.y.data, frame.u.data, frame.v.data };
+		int dstLinesize[] = { (int)frame.y.step, (int)frame.u.step, (int)frame.v.step };
+		sws_scale(m_yuvSwsContext, m_frame->data, m_frame->linesize, 0, height, dstData, dstLinesize);
+	}
+
+	av_frame_unref(m_frame);
+	return true;
+}
+
+int FFmpegFrameSource::GetScaleFlags() const
+{
+	//area averaging when downscaling, same interpolation as cv::VideoCapture otherwise
+	return m_outputSize != m_frameSize ? SWS_AREA : SWS_BICUBIC;
+}
+
+bool FFmpegFrameSource::Seek(int frameIndex)
+{
+	if (m_codecContext == nullptr)
+	{
+		return false;
+	}
+
+	AVStream* stream = m_formatContext->streams[m_videoStreamIndex];
+	const int64_t streamStart = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+
+	if (m_constantFrameRate && frameIndex > 0)
+	{
+		if (!m_firstFramePtsKnown)
+		{
+			//frame indices are relative to the first decoded frame, not to the stream start time
+			if (av_seek_frame(m_formatContext, m_videoStreamIndex, streamStart, AVSEEK_FLAG_BACKWARD) < 0)
+			{
+				return false;
+			}
+			ResetDecoder();
+			if (!DecodeFrame())
+			{
+				return false;
+			}
+			m_firstFramePts = m_frame->best_effort_timestamp != AV_NOPTS_VALUE ? m_frame->best_effort_timestamp : streamStart;
+			m_firstFramePtsKnown = true;
+			av_frame_unref(m_frame);
+		}
+
+		//jump to the key frame before the requested one and decode up to it
+		AVRational frameDuration = { stream->avg_frame_rate.den, stream->avg_frame_rate.num };
+		int64_t timestamp = m_firstFramePts + av_rescale_q(frameIndex, frameDuration, stream->time_base);
+		if (av_seek_frame(m_formatContext, m_videoStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD) >= 0)
+		{
+			ResetDecoder();
+			while (DecodeFrame())
+			{
+				int64_t index = GetFrameIndex(m_frame);
+				if (index == frameIndex)
+				{
+					m_pendingFrame = true;
+					return true;
+				}
+				av_frame_unref(m_frame);
+
+				if (index == -1 || index > frameIndex)
+				{
+					break; //no timestamps or key frame after the requested frame, decode from the beginning
+				}
+			}
+		}
+	}
+
+	if (av_seek_frame(m_formatContext, m_videoStreamIndex, streamStart, AVSEEK_FLAG_BACKWARD) < 0)
+	{
+		return false;
+	}
+	ResetDecoder();
+
+	for (int i = 0; i < frameIndex; i++)
+	{
+		if (!DecodeFrame())
+		{
+			return false;
+		}
+		av_frame_unref(m_frame);
+	}
+	return true;
+}
+
+void FFmpegFrameSource::ResetDecoder()
+{
+	avcodec_flush_buffers(m_codecContext);
+	av_frame_unref(m_frame);
+	m_flushing = false;
+	m_pendingFrame = false;
+}
+
+int64_t FFmpegFrameSource::GetFrameIndex(const AVFrame* frame) const
+{
+	if (frame->best_effort_timestamp == AV_NOPTS_VALUE)
+	{
+		return -1;
+	}
+
+	AVStream* stream = m_formatContext->streams[m_videoStreamIndex];
+	AVRational frameDuration = { stream->avg_frame_rate.den, stream->avg_frame_rate.num };
+	return av_rescale_q(frame->best_effort_timestamp - m_firstFramePts, stream->time_base, frameDuration);
+}
+
+bool FFmpegFrameSource::DecodeFrame()
+{
+	if (m_pendingFrame)
+	{
+		m_pendingFrame = false;
+		return true;
+	}
+
+	while (true)
+	{
+		int ret = avcodec_receive_frame(m_codecContext, m_frame);
+		if (ret == 0)
+		{
+			return true;
+		}
+		if (ret != AVERROR(EAGAIN) || m_flushing)
+		{
+			return false; //decoder fully drained or decoding error
+		}
+
+		//decoder needs more input
+		if (av_read_frame(m_formatContext, m_packet) < 0)
+		{
+			m_flushing = true;
+			avcodec_send_packet(m_codecContext, NULL); //enter draining mode
+			continue;
+		}
+
+		if (m_packet->stream_index == m_videoStreamIndex && avcodec_send_packet(m_codecContext, m_packet) < 0)
+		{
+			LOG_CORE_WARNING("Failed to decode video packet");
+		}
+		av_packet_unref(m_packet);
+	}
+}
+
+void FFmpegFrameSource::Release()
+{
+	if (m_swsContext != nullptr)
+	{
+		sws_freeContext(m_swsContext); m_swsContext = nullptr;
+	}
+	if (m_yuvSwsContext != nullptr)
+	{
+		sws_freeContext(m_yuvSwsContext); m_yuvSwsContext = nullptr;
+	}
+	if (m_frame != nullptr)
+	{
+		av_frame_free(&m_frame);
+	}
+	if (m_packet != nullptr)
+	{
+		av_packet_free(&m_packet);
+	}
+	if (m_codecContext != nullptr)
+	{
+		avcodec_free_context(&m_codecContext);
+	}
+	if (m_formatContext != nullptr)
+	{
+		avformat_close_input(&m_formatContext);
+	}
+	m_videoStreamIndex = -1;
+	m_flushing = false;
+	m_pendingFrame = false;
+	m_firstFramePtsKnown = false;
+}
+
+}
@@ -0,0 +1,101 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Frame source that demuxes and decodes the video directly with FFmpeg.
+// A single AVFormatContext is used to probe the video information and to
+// decode it, the decoder runs with frame and slice threading and all the
+// non-video streams are discarded by the demuxer.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "IFrameSource.h"
+#include <opencv2/core/types.hpp>
+#include <cstdint>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+struct SwsContext;
+
+namespace iris
+{
+struct YuvFrame;
+
+class FFmpegFrameSource : public IFrameSource
+{
+public:
+	/// <param name="decoderThreads:"> number of decoding threads, 0 lets FFmpeg choose </param>
+	FFmpegFrameSource(int decoderThreads = 0);
+	virtual ~FFmpegFrameSource();
+
+	/// <summary>
+	/// Opens the video file, probes its information and initializes the decoder
+	/// </summary>
+	/// <param name="outputScale:"> proportion of the video resolution at which frames are output. Frames are
+	/// downscaled during the color conversion and, if the codec supports it, decoded at a lower resolution </param>
+	/// <returns>false if the video could not be opened or has no decodable video stream</returns>
+	bool Open(const char* sourceVideo, float outputScale = 1.0f);
+
+	virtual bool Read(cv::Mat& frame) override;
+
+	/// <summary>
+	/// Positions the video so that the next read frame is the frame at frameIndex. Constant frame rate
+	/// videos jump to the previous key frame, otherwise the video is decoded from the beginning
+	/// </summary>
+	/// <returns>false if the video has less frames than frameIndex</returns>
+	bool Seek(int frameIndex);
+
+	/// <summary>
+	/// Decodes the next video frame as 8 bit 4:2:0 YUV planes without converting it to BGR.
+	/// I420 and NV12 frames are copied as they are, other pixel formats are converted to I420
+	/// </summary>
+	/// <returns>false if there are no more frames to read</returns>
+	bool Read(YuvFrame& frame);
+
+	virtual void Release() override;
+
+	inline int GetFps() const { return m_fps; }
+	inline int GetFrameCount() const { return m_frameCount; }
+	inline cv::Size GetFrameSize() const { return m_frameSize; } //video resolution
+	inline cv::Size GetOutputSize() const { return m_outputSize; } //resolution of the read frames
+
+private:
+
+	/// <summary>
+	/// Reads packets and sends them to the decoder until a new frame is decoded into m_frame
+	/// </summary>
+	/// <returns>false when the end of the video is reached</returns>
+	bool DecodeFrame();
+
+	//discards all buffered packets and frames after a seek
+	void ResetDecoder();
+
+	//frame index of a decoded frame obtained from its timestamp, -1 if unknown
+	int64_t GetFrameIndex(const AVFrame* frame) const;
+
+	//swscale interpolation for the frame conversion
+	int GetScaleFlags() const;
+
+	AVFormatContext* m_formatContext = nullptr;
+	AVCodecContext* m_codecContext = nullptr;
+	AVPacket* m_packet = nullptr;
+	AVFrame* m_frame = nullptr;
+	SwsContext* m_swsContext = nullptr;
+	SwsContext* m_yuvSwsContext = nullptr;
+
+	int m_decoderThreads = 0;
+	int m_videoStreamIndex = -1;
+	bool m_flushing = false; //end of file reached, draining decoder
+	bool m_pendingFrame = false; //m_frame was decoded while seeking and has not been read yet
+	bool m_constantFrameRate = false;
+	bool m_firstFramePtsKnown = false;
+	int64_t m_firstFramePts = 0; //timestamp of the first video frame, obtained on the first seek
+
+	int m_fps = 0;
+	int m_frameCount = 0;
+	cv::Size m_frameSize;
+	cv::Size m_outputSize;
+};
+
+}
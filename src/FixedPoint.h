@@ -0,0 +1,70 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Fixed point (Q16) flash values. The sRGB look up table and the luminance
+// coefficients are converted once to integers, so the relative luminance
+// and red saturation of every pixel are int32 values and the frame means
+// are obtained from exact 64 bit sums. The results do not depend on the
+// number of threads, the vector width or the compiler.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+namespace iris::FixedPoint
+{
+	constexpr int Shift = 16;
+	constexpr int One = 1 << Shift; //1.0 in fixed point
+
+	inline int ToFixed(double value)
+	{
+		return (int)std::lround(value * One);
+	}
+
+	/// <summary>
+	/// Mean of the fixed point values of a frame from their exact sum
+	/// </summary>
+	inline float ToMean(long long sum, size_t pixels)
+	{
+		return pixels > 0 ? (float)((double)sum / ((double)One * pixels)) : 0;
+	}
+
+	/// <summary>
+	/// Red saturation of a pixel from its fixed point linear sRGB values
+	/// </summary>
+	inline int RedSaturation(int r, int g, int b)
+	{
+		//R / (R + G + B) >= 0.8 <=> 5 * R >= 4 * (R + G + B), the ratio threshold is exact in integers
+		const int red = r - g - b;
+		return red > 0 && 5 * r >= 4 * (r + g + b) ? red * 320 : 0;
+	}
+
+	struct FlashTables
+	{
+		/// <param name="sRgbValues">8 bit to linear sRGB look up table</param>
+		explicit FlashTables(const std::vector<float>& sRgbValues)
+		{
+			for (float value : sRgbValues)
+			{
+				sRgb.push_back(ToFixed(value));
+
+				//Y = 0.0722 * B + 0.7152 * G + 0.2126 * R
+				blueLuminance.push_back(ToFixed(0.0722 * value));
+				greenLuminance.push_back(ToFixed(0.7152 * value));
+				redLuminance.push_back(ToFixed(0.2126 * value));
+			}
+		}
+
+		inline int Luminance(int b, int g, int r) const
+		{
+			return blueLuminance[b] + greenLuminance[g] + redLuminance[r];
+		}
+
+		std::vector<int> sRgb;
+		std::vector<int> blueLuminance;
+		std::vector<int> greenLuminance;
+		std::vector<int> redLuminance;
+	};
+}
@@ -11,14 +11,37 @@ Abstract class for Flash detection
 #include "ConfigurationParams.h"
 #include <limits>
 #include <math.h>
+#include <cmath>
 #include "iris/Log.h"
 #include "IFrameManager.h"
+#include "FrameBufferPool.h"
+#include "FlashKernels.h"
+#include "FixedPoint.h"
+#include "ExclusionMask.h"
+#include "SparseFrame.h"
+#include <atomic>
 
 namespace iris
 {
+    namespace
+    {
+        //values of the columns from begin to end of the row, sparse rows are expanded in the buffer
+        const float* RowValues(const cv::Mat& frame, const SparseFrame* sparseFrame, int row, int begin, int end, std::vector<float>& buffer)
+        {
+            if (sparseFrame == nullptr)
+            {
+                return frame.ptr<float>(row) + begin;
+            }
+            buffer.resize(end - begin);
+            sparseFrame->ExpandRow(row, begin, end, buffer.data());
+            return buffer.data();
+        }
+    }
+
     short Flash::fps = 0;
 
-	Flash::Flash(short fps, const cv::Size& frameSize, FlashParams* flashParams, IFrameManager* frameManager) : m_frameManager(frameManager)
+	Flash::Flash(short fps, const cv::Size& frameSize, FlashParams* flashParams, IFrameManager* frameManager, FrameBufferPool* framePool)
+        : m_framePool(framePool), m_frameManager(frameManager)
     {
         Flash::fps = fps;
 
@@ -26,6 +49,7 @@ namespace iris
         m_avgDiffInSecond.reserve(fps);
         m_avgDiffInSecond.emplace_back(0); //initial frame
         m_frameSize = frameSize.area();
+        m_frameArea = cv::Rect(cv::Point(0, 0), frameSize);
         m_safeArea = frameSize.area() * m_params->areaProportion;
 
         m_managerIndx = m_frameManager->RegisterManager(fps, TIME_WINDOW);
@@ -36,51 +60,217 @@ namespace iris
 
     Flash::~Flash(){}
 
-    void Flash::ReleaseLastFrame()
+    cv::Mat Flash::AcquireFrame(const cv::Size& size)
     {
-        if (lastFrame != nullptr) {
-            lastFrame->release();
-            delete lastFrame;
-            lastFrame = nullptr;
+        if (m_framePool != nullptr)
+        {
+            return m_framePool->Acquire(size, CV_32FC1);
         }
+        return cv::Mat(size, CV_32FC1);
     }
 
-    void Flash::ReleaseCurrentFrame()
+    const cv::Mat& Flash::FrameDifference()
     {
-        if (currentFrame != nullptr) {
-            currentFrame->release();
-            delete currentFrame;
-            currentFrame = nullptr;
+        if (!HasFrames()) {
+            m_frameDifference.release();
+            return m_frameDifference;
+        }
+        if (currentFrame.depth() == CV_32S) {
+            cv::subtract(currentFrame, lastFrame, m_frameDifference); //fixed point values
+            return m_frameDifference;
         }
+        m_frameDifference.create(GetFrameSize(), CV_32FC1); //no allocation once the buffer has the frame size
+        const FlashKernels& kernels = FlashKernels::Get();
+        const int cols = m_frameDifference.cols;
+
+        cv::parallel_for_(cv::Range(0, m_frameDifference.rows), [&](const cv::Range& range)
+        {
+            std::vector<float> currentBuffer, lastBuffer;
+            for (int row = range.start; row < range.end; row++)
+            {
+                kernels.subtract(RowValues(currentFrame, m_sparseCurrentFrame, row, 0, cols, currentBuffer), 
+                    RowValues(lastFrame, m_sparseLastFrame, row, 0, cols, lastBuffer), m_frameDifference.ptr<float>(row), cols);
+            }
+        });
+        return m_frameDifference;
     }
 
-    cv::Mat* Flash::FrameDifference()
+    float Flash::FrameMean()
     {
-        if (currentFrame == nullptr || lastFrame == nullptr) {
-            return nullptr;
+        if (m_sparseCurrentFrame != nullptr)
+        {
+            return m_sparseCurrentFrame->Sum() / m_sparseCurrentFrame->Size().area();
+        }
+        if (currentFrame.depth() == CV_32S)
+        {
+            return cv::mean(currentFrame)[0] / FixedPoint::One;
         }
-        cv::Mat* ptrFrameDiff = new cv::Mat();
-        cv::subtract(*currentFrame, *lastFrame, *ptrFrameDiff);
-        return ptrFrameDiff;
+        return cv::mean(currentFrame)[0];
     }
 
-    float Flash::FrameMean()
+    void Flash::SetCurrentFrame(const cv::Mat& flashValuesFrame)
     {
-        return cv::mean(*currentFrame)[0];
+        SetCurrentFrame(flashValuesFrame, -1);
     }
 
-    void Flash::SetCurrentFrame(cv::Mat* flashValuesFrame)
+    void Flash::SetCurrentFrame(const cv::Mat& flashValuesFrame, float frameMean)
     {
+        //the last frame buffer is released and can be reused by the frame pool
         lastFrame = currentFrame;
+        m_sparseLastFrame = m_sparseCurrentFrame;
         currentFrame = flashValuesFrame;
+        m_sparseCurrentFrame = nullptr;
 
         m_avgLastFrame = m_avgCurrentFrame;
-        m_avgCurrentFrame = FrameMean();
+        m_avgCurrentFrame = (frameMean < 0 ? FrameMean() : frameMean) * m_frameAreaProportion;
     }
 
-    float Flash::CheckSafeArea(cv::Mat* frameDifference)
+    void Flash::SetCurrentFrame(const SparseFrame& sparseFrame, float frameMean)
     {
-        int variation = cv::countNonZero(*frameDifference);
+        lastFrame = currentFrame;
+        m_sparseLastFrame = m_sparseCurrentFrame;
+        currentFrame.release();
+        m_sparseCurrentFrame = &sparseFrame;
+
+        m_avgLastFrame = m_avgCurrentFrame;
+        m_avgCurrentFrame = (frameMean < 0 ? FrameMean() : frameMean) * m_frameAreaProportion;
+    }
+
+    void Flash::RepeatCurrentFrame()
+    {
+        lastFrame = currentFrame;
+        m_sparseLastFrame = m_sparseCurrentFrame;
+        m_avgLastFrame = m_avgCurrentFrame;
+    }
+
+    cv::Size Flash::GetFrameSize() const
+    {
+        return m_sparseCurrentFrame != nullptr ? m_sparseCurrentFrame->Size() : currentFrame.size();
+    }
+
+    void Flash::SetFrameArea(const cv::Rect& area)
+    {
+        if (area == m_frameArea)
+        {
+            return;
+        }
+
+        if (m_sparseCurrentFrame != nullptr)
+        {
+            //the sparse frame is moved as dense values
+            currentFrame = AcquireFrame(m_sparseCurrentFrame->Size());
+            m_sparseCurrentFrame->ToDense(currentFrame);
+            m_sparseCurrentFrame = nullptr;
+        }
+
+        if (!currentFrame.empty())
+        {
+            //values outside the last area are black, the frame is no longer shared with the last frame
+            cv::Mat frame(area.size(), currentFrame.type(), cv::Scalar(0));
+            cv::Rect overlap = area & m_frameArea;
+            if (!overlap.empty())
+            {
+                cv::Mat frameOverlap = frame(overlap - area.tl());
+                currentFrame(overlap - m_frameArea.tl()).copyTo(frameOverlap);
+            }
+            currentFrame = frame;
+        }
+
+        m_frameArea = area;
+        m_frameAreaProportion = area.area() / (float)m_frameSize;
+    }
+
+    float Flash::CheckSafeArea(const cv::Mat& frameDifference)
+    {
+        if (frameDifference.depth() == CV_32S)
+        {
+            return CheckSafeArea(cv::countNonZero(frameDifference));
+        }
+
+        const FlashKernels& kernels = FlashKernels::Get();
+        std::atomic<int> variation = 0;
+
+        cv::parallel_for_(cv::Range(0, frameDifference.rows), [&](const cv::Range& range)
+        {
+            int nonZero = 0;
+            for (int row = range.start; row < range.end; row++)
+            {
+                nonZero += kernels.countNonZero(frameDifference.ptr<float>(row), frameDifference.cols);
+            }
+            variation += nonZero;
+        });
+        return CheckSafeArea(variation);
+    }
+
+    int Flash::CountChangedPixels(const cv::Range& rows) const
+    {
+        return CountChangedPixels(cv::Rect(0, rows.start, GetFrameSize().width, rows.end - rows.start));
+    }
+
+    int Flash::CountChangedPixels(const cv::Rect& area) const
+    {
+        if (!HasFrames() || (currentFrame.data == lastFrame.data && m_sparseCurrentFrame == m_sparseLastFrame))
+        {
+            return 0; //no last frame or repeated frame
+        }
+
+        const FlashKernels& kernels = FlashKernels::Get();
+        const bool fixedPoint = currentFrame.depth() == CV_32S;
+        std::vector<float> currentBuffer, lastBuffer; //sparse rows expanded to dense values
+        auto countChanged = [&](int row, int begin, int end)
+        {
+            if (fixedPoint)
+            {
+                return kernels.countChangedFixed(currentFrame.ptr<int>(row) + begin, lastFrame.ptr<int>(row) + begin, end - begin);
+            }
+            if (m_sparseCurrentFrame != nullptr && m_sparseLastFrame != nullptr)
+            {
+                //columns outside the non zero values of both rows are 0 in both frames
+                cv::Range extent = m_sparseCurrentFrame->Extent(row);
+                const cv::Range lastExtent = m_sparseLastFrame->Extent(row);
+                if (extent.empty())
+                {
+                    extent = lastExtent;
+                }
+                else if (!lastExtent.empty())
+                {
+                    extent = cv::Range(std::min(extent.start, lastExtent.start), std::max(extent.end, lastExtent.end));
+                }
+
+                begin = std::max(begin, extent.start);
+                end = std::min(end, extent.end);
+                if (begin >= end)
+                {
+                    return 0;
+                }
+            }
+            return kernels.countChanged(RowValues(currentFrame, m_sparseCurrentFrame, row, begin, end, currentBuffer),
+                RowValues(lastFrame, m_sparseLastFrame, row, begin, end, lastBuffer), end - begin);
+        };
+
+        //excluded pixels are not compared
+        const ExclusionMask* mask = m_exclusionMask != nullptr && m_exclusionMask->frameSize == currentFrame.size() ? m_exclusionMask : nullptr;
+        int changed = 0;
+        for (int row = area.y; row < area.y + area.height; row++)
+        {
+            if (mask == nullptr)
+            {
+                changed += countChanged(row, area.x, area.x + area.width);
+                continue;
+            }
+            mask->ForEachSpan(row, area.x, area.x + area.width, [&](int begin, int end) { changed += countChanged(row, begin, end); });
+        }
+        return changed;
+    }
+
+    float Flash::CheckSafeArea(int variation)
+    {
+        const int values = GetFrameSize().area();
+        if (values > 0 && values != m_frameArea.area())
+        {
+            //values at a lower resolution than the frame (chroma resolution red saturation) cover several pixels
+            variation = (int)std::lround(variation * m_frameArea.area() / (double)values);
+        }
         m_flashArea = variation / (float)m_frameSize;
 
         if (variation >= m_safeArea)
@@ -139,6 +329,14 @@ namespace iris
         return result;
     }
 
+    void Flash::AppendState(std::vector<double>& state) const
+    {
+        state.push_back(m_avgCurrentFrame);
+        state.push_back(m_avgLastFrame);
+        state.push_back(m_avgDiffInSecond.size());
+        state.insert(state.end(), m_avgDiffInSecond.begin(), m_avgDiffInSecond.end());
+    }
+
     float Flash::roundoff(float value, unsigned char prec)
     {
         float pow_10 = std::pow(10.0f, (float)prec);
@@ -14,9 +14,12 @@ namespace cv
 namespace iris
 {
 	class IFrameManager;
+	class FrameBufferPool;
 	struct FlashParams;
 	struct CheckTransitionResult;
 	struct IrisFrame;
+	struct ExclusionMask;
+	class SparseFrame;
 
 	class Flash
 	{
@@ -25,7 +28,8 @@ namespace iris
 		/// <param name="fps"></param>
 		/// <param name="flashParams">struct with config parameters</param>
 		/// <param name="method">method to use to check the flashing area</param>
-		Flash(short fps, const cv::Size& frameSize, FlashParams* flashParams, IFrameManager* frameManager);
+		/// <param name="framePool">buffers in which the flash values are calculated, if null new buffers are allocated</param>
+		Flash(short fps, const cv::Size& frameSize, FlashParams* flashParams, IFrameManager* frameManager, FrameBufferPool* framePool = nullptr);
 
 		virtual ~Flash();
 
@@ -44,17 +48,48 @@ namespace iris
 		/// <summary>
 		/// Calculates the difference between two consecutive frames
 		/// </summary>
-		/// <returns>difference values</returns>
-		cv::Mat* FrameDifference();
+		/// <returns>difference values, the buffer is reused by the next call</returns>
+		const cv::Mat& FrameDifference();
 
 		/// <summary>
-		/// Change the current frame and move the previous one to last frame, to be ready for the next calculation
+		/// Change the current frame and move the previous one to last frame, to be ready for the next calculation.
+		/// The frame is not copied, the flash values must not be modified while they are in use.
+		/// The values can be CV_32FC1 or fixed point (Q16) CV_32SC1
 		/// </summary>
-		/// <param name="sRgbFrame">The new frame with the calculated flash values</param>
-		void virtual SetCurrentFrame(cv::Mat* flashValuesFrame);
+		/// <param name="flashValuesFrame">The new frame with the calculated flash values</param>
+		void virtual SetCurrentFrame(const cv::Mat& flashValuesFrame);
+
+		/// <summary>
+		/// Change the current frame with flash values whose mean has already been calculated
+		/// </summary>
+		/// <param name="frameMean">mean of the flash values, calculated from the frame if negative</param>
+		void SetCurrentFrame(const cv::Mat& flashValuesFrame, float frameMean);
+
+		/// <summary>
+		/// Change the current frame with flash values stored as runs of non zero values. The frame is not copied,
+		/// it must not be modified while it is the current or the last frame
+		/// </summary>
+		void SetCurrentFrame(const SparseFrame& sparseFrame, float frameMean);
 		
 		void virtual SetCurrentFrame(const IrisFrame& irisFrame) {};
 
+		/// <summary>
+		/// Analyses the current flash values again as the next frame, the frame is unchanged from the last one
+		/// </summary>
+		void RepeatCurrentFrame();
+
+		/// <summary>
+		/// Sets the area of the display covered by the next frames, the rest of the display is black and has no flash values.
+		/// Frame means are relative to the full display, the current frame is moved to the new area
+		/// </summary>
+		void SetFrameArea(const cv::Rect& area);
+
+		/// <summary>
+		/// Sets the areas of the frames whose changed pixels are not counted, the mask is only used for frames of its size
+		/// </summary>
+		/// <param name="mask">mask that outlives the flash detection, null to count every pixel</param>
+		inline void SetExclusionMask(const ExclusionMask* mask) { m_exclusionMask = mask; }
+
 		/// <summary>
 		/// Checks if there has been enough variation from one frame to the next, if there is, the
 		/// positive and negative averages are calculated (to ensure only positive/negative values are
@@ -62,7 +97,27 @@ namespace iris
 		/// </summary>
 		/// <param name="frameDifference">difference of flash values as frame(n) - frame(n-1)</param>
 		/// <returns>average frame difference</returns>
-		float CheckSafeArea(cv::Mat* frameDifference);
+		float CheckSafeArea(const cv::Mat& frameDifference);
+
+		/// <summary>
+		/// Same as CheckSafeArea with the frame difference, from the number of pixels that changed.
+		/// If the flash values have a lower resolution than the frame, each value counts as the pixels it covers
+		/// </summary>
+		/// <param name="variation">number of flash values that changed from frame(n-1) to frame(n)</param>
+		/// <returns>average frame difference</returns>
+		float CheckSafeArea(int variation);
+
+		/// <summary>
+		/// Counts the pixels whose flash values changed from the last frame in the given rows,
+		/// without storing the frame difference
+		/// </summary>
+		/// <returns>number of changed pixels, 0 if there is no last frame</returns>
+		int CountChangedPixels(const cv::Range& rows) const;
+
+		/// <summary>
+		/// Counts the pixels whose flash values changed from the last frame in the given area of the frame
+		/// </summary>
+		int CountChangedPixels(const cv::Rect& area) const;
 
 		/// <summary>
 		/// Accumulates the average difference and returns true if a new transition is detected
@@ -81,10 +136,24 @@ namespace iris
 
 		float GetFlashArea() { return m_flashArea;  }
 
+		/// <summary>
+		/// Appends the frame means and the average differences of the current second. The flash values
+		/// are not part of the state as they only depend on the current and last frames of the video
+		/// </summary>
+		void AppendState(std::vector<double>& state) const;
+
 
-		cv::Mat* getCurrentFrame() {
+		/// <summary>
+		/// Dense flash values of the current frame, empty if the current frame is sparse
+		/// </summary>
+		const cv::Mat& getCurrentFrame() const {
 			return currentFrame;
 		}
+
+		/// <summary>
+		/// Size of the current flash values, dense or sparse
+		/// </summary>
+		cv::Size GetFrameSize() const;
 		
 		/// <summary>
 		/// 
@@ -99,13 +168,14 @@ namespace iris
 		/// This method is not called as the values are stored in a json file and the conversion is done with a look up table for performance
 		/// </summary>
 		void CalculateSrgbValues();
-
-		void ReleaseLastFrame();
-		
-		void ReleaseCurrentFrame();
 		
 	protected:
 
+		/// <summary>
+		/// Obtains a buffer for the flash values of a new frame
+		/// </summary>
+		cv::Mat AcquireFrame(const cv::Size& size);
+
 		/// <summary>
 		/// Determines if a transition has occurred 
 		/// Returns true if a new transition occurrs
@@ -114,8 +184,21 @@ namespace iris
 		/// <param name="avgDiffAcc">new accumulated average difference</param>
 		bool IsFlashTransition(const float& lastAvgDiffAcc, const float& avgDiffAcc, const float& threshold);
 
-		cv::Mat* lastFrame = nullptr;
-		cv::Mat* currentFrame = nullptr;
+		/// <summary>
+		/// Returns true if there are current and last flash values, dense or sparse
+		/// </summary>
+		inline bool HasFrames() const
+		{
+			return (!currentFrame.empty() || m_sparseCurrentFrame != nullptr) && (!lastFrame.empty() || m_sparseLastFrame != nullptr);
+		}
+
+		cv::Mat lastFrame;
+		cv::Mat currentFrame;
+		const SparseFrame* m_sparseLastFrame = nullptr; //set instead of lastFrame if the last frame is sparse
+		const SparseFrame* m_sparseCurrentFrame = nullptr; //set instead of currentFrame if the current frame is sparse
+		cv::Mat m_frameDifference; //reused to calculate the difference of every frame
+		FrameBufferPool* m_framePool = nullptr;
+		const ExclusionMask* m_exclusionMask = nullptr;
 
 	private:
 		
@@ -135,6 +218,8 @@ namespace iris
 		float m_avgLastFrame = 0;
 		float m_flashArea = 0;
 		int m_frameSize = 0; //frame width * frame height
+		cv::Rect m_frameArea; //area of the display covered by the flash values frames
+		float m_frameAreaProportion = 1; //frame area / display area
 
 		const float TIME_WINDOW = 1.0; //max time to consider for calculating flash frequency
 		int m_managerIndx;
@@ -11,16 +11,20 @@
 #include "iris/Log.h"
 #include "iris/Result.h"
 #include "IFrameManager.h"
+#include "FrameTiles.h"
+#include <atomic>
 
 namespace iris
 {
-	FlashDetection::FlashDetection(Configuration* configuration, const short& fps, const cv::Size& frameSize, IFrameManager* frameManager)
+	FlashDetection::FlashDetection(Configuration* configuration, const short& fps, const cv::Size& frameSize, IFrameManager* frameManager, FrameBufferPool* framePool)
 		: m_sRgbConverter(configuration->GetFrameSrgbConverterParams()), m_fps(fps)
 
 	{
 		m_transitionTracker = new TransitionTracker(fps, configuration->GetTransitionTrackerParams(), frameManager);
-		m_luminance = new RelativeLuminance(fps, frameSize, configuration->GetLuminanceFlashParams(), frameManager);
-		m_redSaturation = new RedSaturation(fps, frameSize, configuration->GetRedSaturationFlashParams(), frameManager);
+		m_luminance = new RelativeLuminance(fps, frameSize, configuration->GetLuminanceFlashParams(), frameManager, framePool);
+		RedSaturation* redSaturation = new RedSaturation(fps, frameSize, configuration->GetRedSaturationFlashParams(), frameManager, framePool);
+		redSaturation->SetSparseFramesEnabled(configuration->SparseRedSaturationEnabled());
+		m_redSaturation = redSaturation;
 	}
 
 	FlashDetection::~FlashDetection()
@@ -42,20 +46,20 @@ namespace iris
 	void FlashDetection::setLuminance(IrisFrame& irisFrame)
 	{
 		m_luminance->SetCurrentFrame(irisFrame);
-		irisFrame.luminanceFrame = m_luminance->getCurrentFrame();
+		irisFrame.luminanceFrame = &m_luminance->getCurrentFrame();
 	}
 
 	void FlashDetection::checkFrame(const IrisFrame& irisFrame, const int& framePos, FrameData& data)
 	{
 		//red saturarion
-		m_redSaturation->SetCurrentFrame(irisFrame.sRgbFrame);
+		m_redSaturation->SetCurrentFrame(irisFrame);
 
 		data.LuminanceAverage = m_luminance->GetFrameMean();
 		data.RedAverage = m_redSaturation->GetFrameMean();
 
 		if (framePos != 0) //check difference between frame(n) and frame (n - 1)
 		{
-			frameDifference(framePos, data);
+			frameDifference(framePos, data, irisFrame.changedTiles);
 			m_transitionTracker->EvaluateFrameMoment(data);
 		}
 
@@ -63,16 +67,49 @@ namespace iris
 		data.AverageRedDiffAcc = m_lastAvgRedDiffAcc;
 	}
 
-	void FlashDetection::frameDifference(const int& framePos, FrameData& data)
+	void FlashDetection::frameDifference(const int& framePos, FrameData& data, const FrameTiles* changedTiles)
 	{
-		//Red Saturation difference 
-		cv::Mat* redSaturationDiff = m_redSaturation->FrameDifference();
-		
-		//Luminance difference
-		cv::Mat* luminanceDiff = m_luminance->FrameDifference();
+		//Luminance and Red Saturation changed pixels, counted in a single pass without storing the frame differences.
+		//Red saturation may have a lower resolution than the luminance, then its changed values are counted separately
+		std::atomic<int> luminanceVariation = 0, redVariation = 0;
+		const bool sameResolution = m_luminance->GetFrameSize() == m_redSaturation->GetFrameSize();
+		if (changedTiles != nullptr)
+		{
+			//pixels of unchanged tiles have the same values as in the last frame
+			cv::parallel_for_(cv::Range(0, changedTiles->Count()), [&](const cv::Range& range)
+			{
+				int luminanceChanged = 0, redChanged = 0;
+				for (int tile = range.start; tile < range.end; tile++)
+				{
+					if (changedTiles->changed[tile])
+					{
+						luminanceChanged += m_luminance->CountChangedPixels(changedTiles->Tile(tile));
+						redChanged += sameResolution ? m_redSaturation->CountChangedPixels(changedTiles->Tile(tile)) : 0;
+					}
+				}
+				luminanceVariation += luminanceChanged;
+				redVariation += redChanged;
+			});
+		}
+		else
+		{
+			cv::parallel_for_(cv::Range(0, m_luminance->GetFrameSize().height), [&](const cv::Range& range)
+			{
+				luminanceVariation += m_luminance->CountChangedPixels(range);
+				redVariation += sameResolution ? m_redSaturation->CountChangedPixels(range) : 0;
+			});
+		}
+
+		if (!sameResolution)
+		{
+			cv::parallel_for_(cv::Range(0, m_redSaturation->GetFrameSize().height), [&](const cv::Range& range)
+			{
+				redVariation += m_redSaturation->CountChangedPixels(range);
+			});
+		}
 		
-		float averageLuminaceDiff = m_luminance->CheckSafeArea(luminanceDiff);
-		float averageRedDiff = m_redSaturation->CheckSafeArea(redSaturationDiff);
+		float averageLuminaceDiff = m_luminance->CheckSafeArea(luminanceVariation);
+		float averageRedDiff = m_redSaturation->CheckSafeArea(redVariation);
 
 		Flash::CheckTransitionResult redTranstion = m_redSaturation->CheckTransition(averageRedDiff, m_lastAvgRedDiffAcc);
 		m_lastAvgRedDiffAcc = redTranstion.lastAvgDiffAcc;
@@ -88,9 +125,6 @@ namespace iris
 
 		data.AverageLuminanceDiff = averageLuminaceDiff;
 		data.AverageRedDiff = averageRedDiff;
-
-		delete redSaturationDiff;
-		delete luminanceDiff;
 	}
 	
 	bool FlashDetection::isFail()
@@ -103,11 +137,37 @@ namespace iris
 		return m_transitionTracker->getLumPassWithWarning() || m_transitionTracker->getRedPassWithWarning();
 	}
 
-	cv::Mat* FlashDetection::getLuminanceFrame()
+	void FlashDetection::setFrameArea(const cv::Rect& area)
+	{
+		m_luminance->SetFrameArea(area);
+		m_redSaturation->SetFrameArea(area);
+	}
+
+	void FlashDetection::setExclusionMask(const ExclusionMask* mask)
+	{
+		m_luminance->SetExclusionMask(mask);
+		m_redSaturation->SetExclusionMask(mask);
+	}
+
+	void FlashDetection::appendState(std::vector<double>& state) const
+	{
+		state.push_back(m_lastAvgLumDiffAcc);
+		state.push_back(m_lastAvgRedDiffAcc);
+		m_luminance->AppendState(state);
+		m_redSaturation->AppendState(state);
+		m_transitionTracker->AppendState(state);
+	}
+
+	const cv::Mat& FlashDetection::getLuminanceFrame()
 	{
 		return m_luminance->getCurrentFrame();
 	}
 
+	const cv::Mat& FlashDetection::getRedSaturationFrame()
+	{
+		return m_redSaturation->getCurrentFrame();
+	}
+
 	void FlashDetection::setResult(Result& result)
 	{
 		//set incident counters
@@ -25,13 +25,17 @@ namespace iris
 	class Flash;
 	class FrameData;
 	class IFrameManager;
+	class FrameBufferPool;
 	struct IrisFrame;
 	struct Result;
+	struct FrameTiles;
+	struct ExclusionMask;
 
 	class FlashDetection : public PhotosensitivityDetector
 	{
 	public:
-		FlashDetection(Configuration* configuration, const short& fps, const cv::Size& frameSize, IFrameManager* frameManager);
+		/// <param name="framePool">buffers recycled for the luminance and red saturation frames, if null new buffers are allocated</param>
+		FlashDetection(Configuration* configuration, const short& fps, const cv::Size& frameSize, IFrameManager* frameManager, FrameBufferPool* framePool = nullptr);
 		~FlashDetection();
 
 		/// <summary>
@@ -63,7 +67,24 @@ namespace iris
 		/// </summary>
 		void setResult(Result& result) override;
 
-		cv::Mat* getLuminanceFrame();
+		/// <summary>
+		/// Sets the area of the display covered by the next frames, flash areas and means stay relative to the full display
+		/// </summary>
+		void setFrameArea(const cv::Rect& area);
+
+		/// <summary>
+		/// Sets the areas of the frames whose changed pixels are not counted, null to count every pixel
+		/// </summary>
+		void setExclusionMask(const ExclusionMask* mask);
+
+		const cv::Mat& getLuminanceFrame();
+		const cv::Mat& getRedSaturationFrame();
+
+		/// <summary>
+		/// Appends the values that, with the next frames of the video, determine the next flash results.
+		/// Detections with equal states give the same frame data for the same next frames
+		/// </summary>
+		void appendState(std::vector<double>& state) const;
 
 	private:
 
@@ -72,7 +93,8 @@ namespace iris
 		/// </summary>
 		/// <param name="framePos">current frame position</param>
 		/// <param name="data">FrameData to persist</param>
-		void frameDifference(const int& framePos, FrameData& data);
+		/// <param name="changedTiles">tiles of the frame that changed from the last frame, every pixel is compared if null</param>
+		void frameDifference(const int& framePos, FrameData& data, const FrameTiles* changedTiles);
 
 		TransitionTracker* m_transitionTracker;
 		Flash* m_luminance = nullptr;
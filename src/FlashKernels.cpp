@@ -0,0 +1,103 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include "FlashKernels.h"
+#include <opencv2/core/utility.hpp>
+
+namespace iris
+{
+	namespace
+	{
+		void RelativeLuminance(const float* sRgb, float* luminance, int pixels)
+		{
+			for (int i = 0; i < pixels; i++, sRgb += 3)
+			{
+				luminance[i] = 0.0722f * sRgb[0] + 0.7152f * sRgb[1] + 0.2126f * sRgb[2];
+			}
+		}
+
+		void RedSaturation(const float* sRgb, float* redSaturation, int pixels)
+		{
+			for (int i = 0; i < pixels; i++, sRgb += 3)
+			{
+				const float b = sRgb[0], g = sRgb[1], r = sRgb[2];
+				const float red = (r - g - b) * 320;
+
+				//NaN ratios (black pixels) and negative values are set to 0
+				redSaturation[i] = r / (r + g + b) >= 0.8f && red > 0 ? red : 0;
+			}
+		}
+
+		void Subtract(const float* a, const float* b, float* difference, int count)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				difference[i] = a[i] - b[i];
+			}
+		}
+
+		int CountNonZero(const float* values, int count)
+		{
+			int nonZero = 0;
+			for (int i = 0; i < count; i++)
+			{
+				nonZero += values[i] != 0;
+			}
+			return nonZero;
+		}
+
+		int CountChanged(const float* a, const float* b, int count)
+		{
+			int changed = 0;
+			for (int i = 0; i < count; i++)
+			{
+				changed += a[i] - b[i] != 0;
+			}
+			return changed;
+		}
+
+		int CountChangedFixed(const int* a, const int* b, int count)
+		{
+			int changed = 0;
+			for (int i = 0; i < count; i++)
+			{
+				changed += a[i] != b[i];
+			}
+			return changed;
+		}
+	}
+
+	const FlashKernels& FlashKernelsIsa::Scalar()
+	{
+		static const FlashKernels kernels = { "Scalar", RelativeLuminance, RedSaturation, Subtract, CountNonZero, CountChanged, CountChangedFixed };
+		return kernels;
+	}
+
+	std::vector<const FlashKernels*> FlashKernels::GetSupported()
+	{
+		std::vector<const FlashKernels*> supported = { &FlashKernelsIsa::Scalar() };
+
+#ifdef IRIS_SIMD_NEON
+		supported.push_back(&FlashKernelsIsa::Neon());
+#endif
+#ifdef IRIS_SIMD_AVX2
+		if (cv::checkHardwareSupport(CV_CPU_AVX2))
+		{
+			supported.push_back(&FlashKernelsIsa::Avx2());
+		}
+#endif
+#ifdef IRIS_SIMD_AVX512
+		if (cv::checkHardwareSupport(CV_CPU_AVX_512F))
+		{
+			supported.push_back(&FlashKernelsIsa::Avx512());
+		}
+#endif
+		return supported;
+	}
+
+	const FlashKernels& FlashKernels::Get()
+	{
+		//the last supported implementation is the fastest, OPENCV_CPU_DISABLE can be used to force a fallback
+		static const FlashKernels* kernels = GetSupported().back();
+		return *kernels;
+	}
+}
@@ -0,0 +1,58 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Row kernels used to obtain the flash values of a frame. Each instruction
+// set has its own implementation (scalar, AVX2, AVX-512 and NEON) built
+// in a separate translation unit with its own compiler flags, the best
+// one supported by the CPU is selected the first time they are used.
+// All implementations perform the same floating point operations in the
+// same order (no fused multiply-add) so their results are bit-identical.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+
+namespace iris
+{
+	struct FlashKernels
+	{
+		const char* name; //instruction set of the implementation
+
+		//Y = 0.0722 * B + 0.7152 * G + 0.2126 * R of each interleaved sRGB (BGR order) pixel
+		void (*relativeLuminance)(const float* sRgb, float* luminance, int pixels);
+
+		//(R - G - B) * 320 if R / (R + G + B) >= 0.8 and the value is positive, 0 otherwise
+		void (*redSaturation)(const float* sRgb, float* redSaturation, int pixels);
+
+		//difference = a - b
+		void (*subtract)(const float* a, const float* b, float* difference, int count);
+
+		//number of values different from 0
+		int (*countNonZero)(const float* values, int count);
+
+		//number of values where a - b is different from 0, same as subtract and countNonZero without storing the difference
+		int (*countChanged)(const float* a, const float* b, int count);
+
+		//number of fixed point values where a is different from b
+		int (*countChangedFixed)(const int* a, const int* b, int count);
+
+		/// <summary>
+		/// Obtains the fastest implementation supported by the CPU
+		/// </summary>
+		static const FlashKernels& Get();
+
+		/// <summary>
+		/// Obtains all the implementations supported by the CPU, the scalar one first
+		/// </summary>
+		static std::vector<const FlashKernels*> GetSupported();
+	};
+
+	//implementations of each instruction set, the SIMD ones are only built for their architecture
+	namespace FlashKernelsIsa
+	{
+		const FlashKernels& Scalar();
+		const FlashKernels& Avx2();
+		const FlashKernels& Avx512();
+		const FlashKernels& Neon();
+	}
+}
@@ -0,0 +1,130 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+//Built with AVX2 enabled, only called if the CPU supports it
+#include "FlashKernels.h"
+#include <immintrin.h>
+
+namespace iris
+{
+	namespace
+	{
+		//loads 8 interleaved BGR pixels as one register per channel
+		inline void Load8(const float* p, __m256& b, __m256& g, __m256& r)
+		{
+			__m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1);
+			__m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+			__m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+
+			__m256 gb = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+			__m256 rg = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+			b = _mm256_shuffle_ps(m03, gb, _MM_SHUFFLE(2, 0, 3, 0));
+			g = _mm256_shuffle_ps(rg, gb, _MM_SHUFFLE(3, 1, 2, 0));
+			r = _mm256_shuffle_ps(rg, m25, _MM_SHUFFLE(3, 0, 3, 1));
+		}
+
+		void RelativeLuminance(const float* sRgb, float* luminance, int pixels)
+		{
+			const __m256 kb = _mm256_set1_ps(0.0722f), kg = _mm256_set1_ps(0.7152f), kr = _mm256_set1_ps(0.2126f);
+
+			int i = 0;
+			for (; i + 8 <= pixels; i += 8)
+			{
+				__m256 b, g, r;
+				Load8(sRgb + i * 3, b, g, r);
+				__m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(kb, b), _mm256_mul_ps(kg, g)), _mm256_mul_ps(kr, r));
+				_mm256_storeu_ps(luminance + i, y);
+			}
+			FlashKernelsIsa::Scalar().relativeLuminance(sRgb + i * 3, luminance + i, pixels - i);
+		}
+
+		void RedSaturation(const float* sRgb, float* redSaturation, int pixels)
+		{
+			const __m256 threshold = _mm256_set1_ps(0.8f), scale = _mm256_set1_ps(320), zero = _mm256_setzero_ps();
+
+			int i = 0;
+			for (; i + 8 <= pixels; i += 8)
+			{
+				__m256 b, g, r;
+				Load8(sRgb + i * 3, b, g, r);
+				__m256 ratio = _mm256_div_ps(r, _mm256_add_ps(_mm256_add_ps(r, g), b));
+				__m256 red = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(r, g), b), scale);
+
+				//ordered comparisons are false for NaN, selected values are kept and the rest set to 0
+				__m256 mask = _mm256_and_ps(_mm256_cmp_ps(ratio, threshold, _CMP_GE_OQ), _mm256_cmp_ps(red, zero, _CMP_GT_OQ));
+				_mm256_storeu_ps(redSaturation + i, _mm256_and_ps(red, mask));
+			}
+			FlashKernelsIsa::Scalar().redSaturation(sRgb + i * 3, redSaturation + i, pixels - i);
+		}
+
+		void Subtract(const float* a, const float* b, float* difference, int count)
+		{
+			int i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm256_storeu_ps(difference + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+			}
+			FlashKernelsIsa::Scalar().subtract(a + i, b + i, difference + i, count - i);
+		}
+
+		int CountNonZero(const float* values, int count)
+		{
+			//each lane subtracts the all ones (-1) mask of the non zero values
+			__m256i lanes = _mm256_setzero_si256();
+			const __m256 zero = _mm256_setzero_ps();
+
+			int i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 nonZero = _mm256_cmp_ps(_mm256_loadu_ps(values + i), zero, _CMP_NEQ_UQ);
+				lanes = _mm256_sub_epi32(lanes, _mm256_castps_si256(nonZero));
+			}
+
+			__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+			sum = _mm_hadd_epi32(sum, sum);
+			sum = _mm_hadd_epi32(sum, sum);
+			return _mm_cvtsi128_si32(sum) + FlashKernelsIsa::Scalar().countNonZero(values + i, count - i);
+		}
+
+		int CountChanged(const float* a, const float* b, int count)
+		{
+			__m256i lanes = _mm256_setzero_si256();
+			const __m256 zero = _mm256_setzero_ps();
+
+			int i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 difference = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+				lanes = _mm256_sub_epi32(lanes, _mm256_castps_si256(_mm256_cmp_ps(difference, zero, _CMP_NEQ_UQ)));
+			}
+
+			__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+			sum = _mm_hadd_epi32(sum, sum);
+			sum = _mm_hadd_epi32(sum, sum);
+			return _mm_cvtsi128_si32(sum) + FlashKernelsIsa::Scalar().countChanged(a + i, b + i, count - i);
+		}
+
+		int CountChangedFixed(const int* a, const int* b, int count)
+		{
+			//each lane subtracts the all ones (-1) mask of the equal values
+			__m256i equalLanes = _mm256_setzero_si256();
+
+			int i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+				equalLanes = _mm256_sub_epi32(equalLanes, equal);
+			}
+
+			__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(equalLanes), _mm256_extracti128_si256(equalLanes, 1));
+			sum = _mm_hadd_epi32(sum, sum);
+			sum = _mm_hadd_epi32(sum, sum);
+			return i - _mm_cvtsi128_si32(sum) + FlashKernelsIsa::Scalar().countChangedFixed(a + i, b + i, count - i);
+		}
+	}
+
+	const FlashKernels& FlashKernelsIsa::Avx2()
+	{
+		static const FlashKernels kernels = { "AVX2", RelativeLuminance, RedSaturation, Subtract, CountNonZero, CountChanged, CountChangedFixed };
+		return kernels;
+	}
+}
@@ -0,0 +1,149 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+//Built with AVX-512F enabled, only called if the CPU supports it
+#include "FlashKernels.h"
+#include <immintrin.h>
+
+namespace iris
+{
+	namespace
+	{
+		//permutation indices to gather channel k of 16 interleaved pixels from three registers (a, b, c):
+		//first from a and b (indices 0-31), then the remaining lanes from c (indices 16-31 of the second permutation)
+		struct ChannelIndices
+		{
+			ChannelIndices(int k)
+			{
+				alignas(64) int first[16], second[16];
+				for (int i = 0; i < 16; i++)
+				{
+					int source = 3 * i + k;
+					first[i] = source < 32 ? source : 0;
+					second[i] = source < 32 ? i : 16 + source - 32;
+				}
+				ab = _mm512_load_si512(first);
+				c = _mm512_load_si512(second);
+			}
+
+			inline __m512 Gather(__m512 a, __m512 b, __m512 c) const
+			{
+				return _mm512_permutex2var_ps(_mm512_permutex2var_ps(a, ab, b), this->c, c);
+			}
+
+			__m512i ab;
+			__m512i c;
+		};
+
+		//loads 16 interleaved BGR pixels as one register per channel, the indices are built once per row
+		struct Deinterleave
+		{
+			inline void Load16(const float* p, __m512& b, __m512& g, __m512& r) const
+			{
+				__m512 m0 = _mm512_loadu_ps(p), m1 = _mm512_loadu_ps(p + 16), m2 = _mm512_loadu_ps(p + 32);
+				b = blue.Gather(m0, m1, m2);
+				g = green.Gather(m0, m1, m2);
+				r = red.Gather(m0, m1, m2);
+			}
+
+			ChannelIndices blue{ 0 }, green{ 1 }, red{ 2 };
+		};
+
+		void RelativeLuminance(const float* sRgb, float* luminance, int pixels)
+		{
+			const __m512 kb = _mm512_set1_ps(0.0722f), kg = _mm512_set1_ps(0.7152f), kr = _mm512_set1_ps(0.2126f);
+
+			const Deinterleave deinterleave;
+
+			int i = 0;
+			for (; i + 16 <= pixels; i += 16)
+			{
+				__m512 b, g, r;
+				deinterleave.Load16(sRgb + i * 3, b, g, r);
+				__m512 y = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(kb, b), _mm512_mul_ps(kg, g)), _mm512_mul_ps(kr, r));
+				_mm512_storeu_ps(luminance + i, y);
+			}
+			FlashKernelsIsa::Scalar().relativeLuminance(sRgb + i * 3, luminance + i, pixels - i);
+		}
+
+		void RedSaturation(const float* sRgb, float* redSaturation, int pixels)
+		{
+			const __m512 threshold = _mm512_set1_ps(0.8f), scale = _mm512_set1_ps(320), zero = _mm512_setzero_ps();
+
+			const Deinterleave deinterleave;
+
+			int i = 0;
+			for (; i + 16 <= pixels; i += 16)
+			{
+				__m512 b, g, r;
+				deinterleave.Load16(sRgb + i * 3, b, g, r);
+				__m512 ratio = _mm512_div_ps(r, _mm512_add_ps(_mm512_add_ps(r, g), b));
+				__m512 red = _mm512_mul_ps(_mm512_sub_ps(_mm512_sub_ps(r, g), b), scale);
+
+				//ordered comparisons are false for NaN, unselected lanes are set to 0
+				__mmask16 mask = _mm512_cmp_ps_mask(ratio, threshold, _CMP_GE_OQ) & _mm512_cmp_ps_mask(red, zero, _CMP_GT_OQ);
+				_mm512_storeu_ps(redSaturation + i, _mm512_maskz_mov_ps(mask, red));
+			}
+			FlashKernelsIsa::Scalar().redSaturation(sRgb + i * 3, redSaturation + i, pixels - i);
+		}
+
+		void Subtract(const float* a, const float* b, float* difference, int count)
+		{
+			int i = 0;
+			for (; i + 16 <= count; i += 16)
+			{
+				_mm512_storeu_ps(difference + i, _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+			}
+			FlashKernelsIsa::Scalar().subtract(a + i, b + i, difference + i, count - i);
+		}
+
+		int CountNonZero(const float* values, int count)
+		{
+			__m512i lanes = _mm512_setzero_si512();
+			const __m512i one = _mm512_set1_epi32(1);
+			const __m512 zero = _mm512_setzero_ps();
+
+			int i = 0;
+			for (; i + 16 <= count; i += 16)
+			{
+				__mmask16 nonZero = _mm512_cmp_ps_mask(_mm512_loadu_ps(values + i), zero, _CMP_NEQ_UQ);
+				lanes = _mm512_mask_add_epi32(lanes, nonZero, lanes, one);
+			}
+			return _mm512_reduce_add_epi32(lanes) + FlashKernelsIsa::Scalar().countNonZero(values + i, count - i);
+		}
+
+		int CountChanged(const float* a, const float* b, int count)
+		{
+			__m512i lanes = _mm512_setzero_si512();
+			const __m512i one = _mm512_set1_epi32(1);
+			const __m512 zero = _mm512_setzero_ps();
+
+			int i = 0;
+			for (; i + 16 <= count; i += 16)
+			{
+				__m512 difference = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+				lanes = _mm512_mask_add_epi32(lanes, _mm512_cmp_ps_mask(difference, zero, _CMP_NEQ_UQ), lanes, one);
+			}
+			return _mm512_reduce_add_epi32(lanes) + FlashKernelsIsa::Scalar().countChanged(a + i, b + i, count - i);
+		}
+
+		int CountChangedFixed(const int* a, const int* b, int count)
+		{
+			__m512i lanes = _mm512_setzero_si512();
+			const __m512i one = _mm512_set1_epi32(1);
+
+			int i = 0;
+			for (; i + 16 <= count; i += 16)
+			{
+				__mmask16 changed = _mm512_cmpneq_epi32_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+				lanes = _mm512_mask_add_epi32(lanes, changed, lanes, one);
+			}
+			return _mm512_reduce_add_epi32(lanes) + FlashKernelsIsa::Scalar().countChangedFixed(a + i, b + i, count - i);
+		}
+	}
+
+	const FlashKernels& FlashKernelsIsa::Avx512()
+	{
+		static const FlashKernels kernels = { "AVX-512", RelativeLuminance, RedSaturation, Subtract, CountNonZero, CountChanged, CountChangedFixed };
+		return kernels;
+	}
+}
@@ -0,0 +1,100 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+//NEON is always available on 64 bit ARM
+#include "FlashKernels.h"
+#include <arm_neon.h>
+
+namespace iris
+{
+	namespace
+	{
+		void RelativeLuminance(const float* sRgb, float* luminance, int pixels)
+		{
+			const float32x4_t kb = vdupq_n_f32(0.0722f), kg = vdupq_n_f32(0.7152f), kr = vdupq_n_f32(0.2126f);
+
+			int i = 0;
+			for (; i + 4 <= pixels; i += 4)
+			{
+				float32x4x3_t bgr = vld3q_f32(sRgb + i * 3);
+				float32x4_t y = vaddq_f32(vaddq_f32(vmulq_f32(kb, bgr.val[0]), vmulq_f32(kg, bgr.val[1])), vmulq_f32(kr, bgr.val[2]));
+				vst1q_f32(luminance + i, y);
+			}
+			FlashKernelsIsa::Scalar().relativeLuminance(sRgb + i * 3, luminance + i, pixels - i);
+		}
+
+		void RedSaturation(const float* sRgb, float* redSaturation, int pixels)
+		{
+			const float32x4_t threshold = vdupq_n_f32(0.8f), scale = vdupq_n_f32(320), zero = vdupq_n_f32(0);
+
+			int i = 0;
+			for (; i + 4 <= pixels; i += 4)
+			{
+				float32x4x3_t bgr = vld3q_f32(sRgb + i * 3);
+				float32x4_t b = bgr.val[0], g = bgr.val[1], r = bgr.val[2];
+				float32x4_t ratio = vdivq_f32(r, vaddq_f32(vaddq_f32(r, g), b));
+				float32x4_t red = vmulq_f32(vsubq_f32(vsubq_f32(r, g), b), scale);
+
+				//comparisons are false for NaN, unselected lanes are set to 0
+				uint32x4_t mask = vandq_u32(vcgeq_f32(ratio, threshold), vcgtq_f32(red, zero));
+				vst1q_f32(redSaturation + i, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(red), mask)));
+			}
+			FlashKernelsIsa::Scalar().redSaturation(sRgb + i * 3, redSaturation + i, pixels - i);
+		}
+
+		void Subtract(const float* a, const float* b, float* difference, int count)
+		{
+			int i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				vst1q_f32(difference + i, vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+			}
+			FlashKernelsIsa::Scalar().subtract(a + i, b + i, difference + i, count - i);
+		}
+
+		int CountNonZero(const float* values, int count)
+		{
+			//each lane subtracts the all ones mask of the values equal to 0
+			uint32x4_t zeros = vdupq_n_u32(0);
+			const float32x4_t zero = vdupq_n_f32(0);
+
+			int i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				zeros = vsubq_u32(zeros, vceqq_f32(vld1q_f32(values + i), zero));
+			}
+			return i - (int)vaddvq_u32(zeros) + FlashKernelsIsa::Scalar().countNonZero(values + i, count - i);
+		}
+
+		int CountChanged(const float* a, const float* b, int count)
+		{
+			uint32x4_t zeros = vdupq_n_u32(0);
+			const float32x4_t zero = vdupq_n_f32(0);
+
+			int i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				float32x4_t difference = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+				zeros = vsubq_u32(zeros, vceqq_f32(difference, zero));
+			}
+			return i - (int)vaddvq_u32(zeros) + FlashKernelsIsa::Scalar().countChanged(a + i, b + i, count - i);
+		}
+
+		int CountChangedFixed(const int* a, const int* b, int count)
+		{
+			uint32x4_t equal = vdupq_n_u32(0);
+
+			int i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				equal = vsubq_u32(equal, vceqq_s32(vld1q_s32(a + i), vld1q_s32(b + i)));
+			}
+			return i - (int)vaddvq_u32(equal) + FlashKernelsIsa::Scalar().countChangedFixed(a + i, b + i, count - i);
+		}
+	}
+
+	const FlashKernels& FlashKernelsIsa::Neon()
+	{
+		static const FlashKernels kernels = { "NEON", RelativeLuminance, RedSaturation, Subtract, CountNonZero, CountChanged, CountChangedFixed };
+		return kernels;
+	}
+}
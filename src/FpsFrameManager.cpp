@@ -31,6 +31,15 @@ int FpsFrameManager::GetCurrentFrameNum(const int& index) const
 	return m_managers[index].maxFrames; //max for fps as it's always set
 }
 
+void FpsFrameManager::AppendState(std::vector<double>& state) const
+{
+	for (const FrameManager& manager : m_managers)
+	{
+		state.push_back(manager.currentFrames);
+		state.push_back(manager.framesToRemove);
+	}
+}
+
 void FpsFrameManager::ResetManager(const int& index, bool removeLast)
 {
 	m_managers[index].framesToRemove = 0;
@@ -45,6 +45,11 @@ public:
 	/// <param name="index:"> Integer to access the desired element in the vectors. </param>
 	virtual void ResetManager(const int& index, bool removeLast = false) override;
 
+	/// <summary>
+	/// Appends the frame counts of the managers, equal states give the same frame counts for the next frames
+	/// </summary>
+	void AppendState(std::vector<double>& state) const;
+
 private:
 
 	struct FrameManager
@@ -0,0 +1,61 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Pool of frame sized matrices that are recycled instead of allocated for
+// every frame. Acquired buffers are shared cv::Mat headers, once every
+// header of a buffer outside the pool has been released the buffer can be
+// handed out again. After the first frames of a video no more memory is
+// allocated as long as the frame size does not change.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+#include <mutex>
+#include <opencv2/core.hpp>
+
+namespace iris
+{
+
+class FrameBufferPool
+{
+public:
+	/// <param name="frameSize">default size of the pool buffers</param>
+	explicit FrameBufferPool(const cv::Size& frameSize) : m_frameSize(frameSize) {};
+
+	/// <summary>
+	/// Obtains a frame size buffer that is not in use, its previous contents are not cleared
+	/// </summary>
+	/// <param name="type">OpenCV type of the buffer (e.g. CV_32FC1)</param>
+	cv::Mat Acquire(int type)
+	{
+		return Acquire(m_frameSize, type);
+	}
+
+	/// <summary>
+	/// Obtains a buffer that is not in use, its previous contents are not cleared
+	/// </summary>
+	cv::Mat Acquire(const cv::Size& size, int type)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const cv::Mat& buffer : m_buffers)
+		{
+			//only the pool holds a reference to the buffer
+			if (buffer.u->refcount == 1 && buffer.type() == type && buffer.size() == size)
+			{
+				return buffer;
+			}
+		}
+
+		m_buffers.emplace_back(size, type);
+		return m_buffers.back();
+	}
+
+	inline size_t Size() const { return m_buffers.size(); }
+
+private:
+	cv::Size m_frameSize;
+	std::vector<cv::Mat> m_buffers;
+	std::mutex m_mutex;
+};
+
+}
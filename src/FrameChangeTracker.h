@@ -0,0 +1,200 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Detects decoded frames that are exact repeats of the previous frame, as
+// found in static sections or in low frame rate content stored at a higher
+// frame rate. The frame planes are compared row by row with the copy of
+// the last frame, so a repeat is only reported if every byte is equal and
+// the flash and pattern results of the last frame can be used again
+// without changing the analysis result. Frames can also be compared by
+// tiles, so only the tiles that changed need to be converted again or
+// have their changed pixels counted.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstring>
+#include <vector>
+#include <initializer_list>
+#include <atomic>
+#include <opencv2/core.hpp>
+#include "YuvFrame.h"
+#include "FrameTiles.h"
+
+namespace iris
+{
+
+class FrameChangeTracker
+{
+public:
+	/// <summary>
+	/// Compares the frame with the last one, if it has changed a copy is kept for the next comparison
+	/// </summary>
+	/// <returns>true if the frame is identical to the last frame</returns>
+	bool IsRepeated(const cv::Mat& frame)
+	{
+		return IsRepeated({ &frame });
+	}
+
+	bool IsRepeated(const YuvFrame& frame)
+	{
+		if (frame.layout == YuvFrame::Layout::NV12)
+		{
+			return IsRepeated({ &frame.y, &frame.u });
+		}
+		return IsRepeated({ &frame.y, &frame.u, &frame.v });
+	}
+
+	/// <summary>
+	/// Compares the frame with the last one by tiles and marks the tiles that changed, the changed tiles are
+	/// copied for the next comparison. The tiles are set up again if the frame size changes
+	/// </summary>
+	/// <returns>true if no tile changed</returns>
+	bool IsRepeated(const cv::Mat& frame, FrameTiles& tiles)
+	{
+		if (tiles.frameSize != frame.size())
+		{
+			tiles = FrameTiles(frame.size());
+		}
+
+		if (m_lastPlanes.size() != 1 || m_lastPlanes[0].size() != frame.size() || m_lastPlanes[0].type() != frame.type())
+		{
+			std::fill(tiles.changed.begin(), tiles.changed.end(), 1);
+			m_lastPlanes.resize(1);
+			frame.copyTo(m_lastPlanes[0]);
+			return false;
+		}
+
+		std::atomic<int> changedTiles = 0;
+		cv::parallel_for_(cv::Range(0, tiles.Count()), [&](const cv::Range& range)
+		{
+			for (int tile = range.start; tile < range.end; tile++)
+			{
+				const cv::Rect area = tiles.Tile(tile);
+				cv::Mat lastTile = m_lastPlanes[0](area);
+				tiles.changed[tile] = !Equal(frame(area), lastTile);
+				if (tiles.changed[tile])
+				{
+					frame(area).copyTo(lastTile);
+					changedTiles++;
+				}
+			}
+		});
+		return changedTiles == 0;
+	}
+
+	/// <summary>
+	/// Compares the YUV frame with the last one by tiles of the luma plane and their chroma and marks the tiles
+	/// that changed, the changed tiles are copied for the next comparison. The tiles are set up again if the frame size changes
+	/// </summary>
+	/// <returns>true if no tile changed</returns>
+	bool IsRepeated(const YuvFrame& frame, FrameTiles& tiles)
+	{
+		if (tiles.frameSize != frame.size())
+		{
+			tiles = FrameTiles(frame.size());
+		}
+
+		const cv::Mat* planes[] = { &frame.y, &frame.u, &frame.v };
+		const size_t planeCount = frame.layout == YuvFrame::Layout::NV12 ? 2 : 3;
+
+		bool sameFormat = m_lastPlanes.size() == planeCount;
+		for (size_t plane = 0; sameFormat && plane < planeCount; plane++)
+		{
+			sameFormat = m_lastPlanes[plane].size() == planes[plane]->size() && m_lastPlanes[plane].type() == planes[plane]->type();
+		}
+		if (!sameFormat)
+		{
+			std::fill(tiles.changed.begin(), tiles.changed.end(), 1);
+			m_lastPlanes.resize(planeCount);
+			for (size_t plane = 0; plane < planeCount; plane++)
+			{
+				planes[plane]->copyTo(m_lastPlanes[plane]);
+			}
+			return false;
+		}
+
+		std::atomic<int> changedTiles = 0;
+		cv::parallel_for_(cv::Range(0, tiles.Count()), [&](const cv::Range& range)
+		{
+			for (int tile = range.start; tile < range.end; tile++)
+			{
+				const cv::Rect area = tiles.Tile(tile);
+
+				//chroma of the tile, tiles have an even size so the chroma areas of the tiles do not overlap
+				const cv::Rect chromaArea = cv::Rect(area.x / 2, area.y / 2, (area.x + area.width + 1) / 2 - area.x / 2,
+					(area.y + area.height + 1) / 2 - area.y / 2) & cv::Rect(cv::Point(0, 0), frame.u.size());
+
+				bool changed = false;
+				for (size_t plane = 0; plane < planeCount; plane++)
+				{
+					const cv::Rect& planeArea = plane == 0 ? area : chromaArea;
+					cv::Mat lastTile = m_lastPlanes[plane](planeArea);
+					if (!Equal((*planes[plane])(planeArea), lastTile))
+					{
+						(*planes[plane])(planeArea).copyTo(lastTile);
+						changed = true;
+					}
+				}
+
+				tiles.changed[tile] = changed;
+				if (changed)
+				{
+					changedTiles++;
+				}
+			}
+		});
+		return changedTiles == 0;
+	}
+
+	/// <summary>
+	/// Forgets the last frame, the next frame is never reported as a repeat
+	/// </summary>
+	void Reset()
+	{
+		m_lastPlanes.clear();
+	}
+
+private:
+	bool IsRepeated(std::initializer_list<const cv::Mat*> planes)
+	{
+		bool repeated = m_lastPlanes.size() == planes.size();
+		size_t plane = 0;
+		for (auto it = planes.begin(); repeated && it != planes.end(); ++it, plane++)
+		{
+			repeated = Equal(**it, m_lastPlanes[plane]);
+		}
+
+		if (!repeated)
+		{
+			m_lastPlanes.resize(planes.size());
+			plane = 0;
+			for (const cv::Mat* frame : planes)
+			{
+				frame->copyTo(m_lastPlanes[plane++]); //no allocation once the buffers have the frame size
+			}
+		}
+		return repeated;
+	}
+
+	static bool Equal(const cv::Mat& frame, const cv::Mat& lastFrame)
+	{
+		if (frame.size() != lastFrame.size() || frame.type() != lastFrame.type())
+		{
+			return false;
+		}
+
+		const size_t rowBytes = frame.cols * frame.elemSize();
+		for (int row = 0; row < frame.rows; row++)
+		{
+			if (std::memcmp(frame.ptr(row), lastFrame.ptr(row), rowBytes) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<cv::Mat> m_lastPlanes; //copy of the planes of the last changed frame
+};
+
+}
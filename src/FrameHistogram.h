@@ -0,0 +1,93 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Per channel 256 bin histograms of an 8 bit BGR frame. The relative
+// luminance is a look up table per channel followed by a linear weighting,
+// so its frame mean only depends on how many pixels have each channel
+// value. Counting the 8 bit values is much cheaper than converting the
+// frame to float flash values, and the means obtained from the integer
+// counts do not depend on the thread split.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <vector>
+#include <mutex>
+#include <opencv2/core.hpp>
+
+namespace iris
+{
+
+class FrameHistogram
+{
+public:
+	/// <param name="sRgbValues">8 bit to linear sRGB look up table</param>
+	explicit FrameHistogram(const std::vector<float>& sRgbValues) : m_sRgbValues(sRgbValues) {};
+
+	/// <summary>
+	/// Counts the values of each channel of the frame
+	/// </summary>
+	/// <param name="frame">video frame (CV_8UC3)</param>
+	void Calculate(const cv::Mat& frame)
+	{
+		for (auto& channel : m_bins) { channel.fill(0); }
+		m_pixels = frame.total();
+
+		std::mutex binsMutex;
+		cv::parallel_for_(cv::Range(0, frame.rows), [&](const cv::Range& range)
+		{
+			std::array<std::array<int, 256>, 3> bins = {};
+			for (int row = range.start; row < range.end; row++)
+			{
+				const uchar* pixel = frame.ptr<uchar>(row);
+				for (int col = 0; col < frame.cols; col++, pixel += 3)
+				{
+					bins[0][pixel[0]]++;
+					bins[1][pixel[1]]++;
+					bins[2][pixel[2]]++;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(binsMutex);
+			for (int channel = 0; channel < 3; channel++)
+			{
+				for (int value = 0; value < 256; value++)
+				{
+					m_bins[channel][value] += bins[channel][value];
+				}
+			}
+		});
+	}
+
+	/// <summary>
+	/// Mean linear sRGB value of each channel (B, G, R) of the last calculated frame
+	/// </summary>
+	cv::Scalar LinearMeans() const
+	{
+		cv::Scalar means;
+		if (m_pixels == 0)
+		{
+			return means;
+		}
+
+		for (int channel = 0; channel < 3; channel++)
+		{
+			double sum = 0;
+			for (int value = 0; value < 256; value++)
+			{
+				sum += m_bins[channel][value] * (double)m_sRgbValues[value];
+			}
+			means[channel] = sum / m_pixels;
+		}
+		return means;
+	}
+
+	inline const std::array<int, 256>& GetBins(int channel) const { return m_bins[channel]; }
+
+private:
+	std::vector<float> m_sRgbValues;
+	std::array<std::array<int, 256>, 3> m_bins = {};
+	size_t m_pixels = 0;
+};
+
+}
@@ -0,0 +1,90 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Bounded blocking queue used to hand decoded frames from the decoder
+// thread to the analysis thread. Push blocks while the queue is full and
+// Pop blocks while it is empty, so the producer can never run further ahead
+// than the queue capacity. Closing the queue wakes up both sides: producers
+// stop pushing and consumers drain the remaining elements.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace iris
+{
+
+template <typename T>
+class FrameQueue
+{
+public:
+	/// <param name="capacity">max number of elements the queue can hold (at least 1)</param>
+	explicit FrameQueue(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {};
+
+	/// <summary>
+	/// Adds a new element to the queue, blocks while the queue is full
+	/// </summary>
+	/// <returns>false if the queue has been closed and the element was discarded</returns>
+	bool Push(T&& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_notFull.wait(lock, [this] { return m_closed || m_queue.size() < m_capacity; });
+
+		if (m_closed)
+		{
+			return false;
+		}
+
+		m_queue.emplace_back(std::move(item));
+		lock.unlock();
+		m_notEmpty.notify_one();
+		return true;
+	}
+
+	/// <summary>
+	/// Obtains the oldest element in the queue, blocks while the queue is empty
+	/// </summary>
+	/// <returns>false if the queue has been closed and there are no elements left</returns>
+	bool Pop(T& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_notEmpty.wait(lock, [this] { return m_closed || !m_queue.empty(); });
+
+		if (m_queue.empty())
+		{
+			return false;
+		}
+
+		item = std::move(m_queue.front());
+		m_queue.pop_front();
+		lock.unlock();
+		m_notFull.notify_one();
+		return true;
+	}
+
+	/// <summary>
+	/// Closes the queue, no more elements are accepted and blocked threads are released
+	/// </summary>
+	void Close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_closed = true;
+		}
+		m_notEmpty.notify_all();
+		m_notFull.notify_all();
+	}
+
+private:
+	std::deque<T> m_queue;
+	size_t m_capacity;
+	bool m_closed = false;
+
+	std::mutex m_mutex;
+	std::condition_variable m_notEmpty;
+	std::condition_variable m_notFull;
+};
+
+}
@@ -0,0 +1,38 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <opencv2/core.hpp>
+
+namespace iris
+{
+
+/// <summary>
+/// Grid of square tiles covering a frame, the last row and column of tiles are cropped to the frame size
+/// </summary>
+struct FrameTiles
+{
+	static constexpr int TileSize = 64;
+
+	FrameTiles() {};
+	explicit FrameTiles(const cv::Size& frameSize) : frameSize(frameSize),
+		cols((frameSize.width + TileSize - 1) / TileSize), rows((frameSize.height + TileSize - 1) / TileSize),
+		changed(cols * rows, 1) {};
+
+	inline int Count() const { return cols * rows; }
+
+	inline cv::Rect Tile(int index) const
+	{
+		const int x = (index % cols) * TileSize;
+		const int y = (index / cols) * TileSize;
+		return cv::Rect(x, y, std::min(TileSize, frameSize.width - x), std::min(TileSize, frameSize.height - y));
+	}
+
+	cv::Size frameSize;
+	int cols = 0;
+	int rows = 0;
+	std::vector<uchar> changed; //1 if the tile changed from the last frame
+};
+
+}
@@ -0,0 +1,30 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+#pragma once
+
+namespace cv
+{
+	class Mat;
+}
+
+namespace iris
+{
+
+class IFrameSource
+{
+public:
+	virtual ~IFrameSource() {};
+
+	/// <summary>
+	/// Decodes the next video frame as a BGR image
+	/// </summary>
+	/// <param name="frame:"> destination frame, (re)allocated if needed </param>
+	/// <returns>false if there are no more frames to read</returns>
+	virtual bool Read(cv::Mat& frame) = 0;
+
+	/// <summary>
+	/// Closes the video and releases the decoder resources
+	/// </summary>
+	virtual void Release() = 0;
+};
+
+}
@@ -6,24 +6,25 @@
 
 namespace iris
 {
+	struct FrameTiles;
+
+	/// <summary>
+	/// Frame views shared by the detectors, the frames are not owned by IrisFrame
+	/// </summary>
 	struct IrisFrame
 	{
 		IrisFrame() {};
-		IrisFrame(cv::Mat* originalFrame, FrameData frameData) : originalFrame(originalFrame), frameData(frameData) {};
-		IrisFrame(cv::Mat* originalFrame, cv::Mat* sRgbFrame, FrameData frameData) : originalFrame(originalFrame), sRgbFrame(sRgbFrame), frameData(frameData) {};
-		
-		void Release() 
-		{
-			//Release only sRgbFrame as originalFrame is a reference, no malloc is done for it
-			if (sRgbFrame != nullptr)
-			{
-				delete sRgbFrame;  sRgbFrame = nullptr;
-			}
-		}
+		IrisFrame(const cv::Mat* originalFrame, FrameData frameData) : originalFrame(originalFrame), frameData(frameData) {};
+		IrisFrame(const cv::Mat* originalFrame, const cv::Mat* sRgbFrame, FrameData frameData) : originalFrame(originalFrame), sRgbFrame(sRgbFrame), frameData(frameData) {};
 
-		cv::Mat* originalFrame = nullptr; //Video frame in BGR color space
-		cv::Mat* sRgbFrame = nullptr; //Converted video frame to sRGB color space
-		cv::Mat* luminanceFrame = nullptr; //Converted video frame to luminance 
+		const cv::Mat* originalFrame = nullptr; //Video frame in BGR color space
+		const cv::Mat* sRgbFrame = nullptr; //Converted video frame to sRGB color space
+		const cv::Mat* luminanceFrame = nullptr; //Converted video frame to luminance 
+		const cv::Mat* redSaturationFrame = nullptr; //Precomputed red saturation values, computed from sRgbFrame if null
+		float luminanceMean = -1; //Precomputed mean of luminanceFrame, calculated from the frame if negative
+		float redSaturationMean = -1; //Precomputed mean of redSaturationFrame, calculated from the frame if negative
+		bool repeatedFrame = false; //The flash values of the last frame are used again, no flash values are calculated
+		const FrameTiles* changedTiles = nullptr; //Tiles whose flash values changed from the last frame, all of them if null
 		FrameData frameData; //Frame info
 	};
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Detects the constant black borders of letterboxed and pillarboxed video,
+// so only the area of the frame with content needs to be analysed. The
+// content area is the bounding box of the non black pixels of the first
+// frames with content. After that every frame checks that the borders are
+// still black, if they are not the area grows to include the new content
+// and is never reduced again. Black border pixels have no luminance and
+// no red saturation, so the flash values of the full display can be
+// obtained from the ones of the content area.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <opencv2/core.hpp>
+
+namespace iris
+{
+
+class LetterboxDetector
+{
+public:
+	/// <param name="blackThreshold">highest channel value of a black border pixel</param>
+	/// <param name="probeFrames">number of frames with content used to find the content area</param>
+	LetterboxDetector(int blackThreshold, int probeFrames) : m_blackThreshold(blackThreshold), m_probeFrames(probeFrames) {};
+
+	/// <summary>
+	/// Updates the content area with the frame, the full frame is analysed until the first frames with
+	/// content have been probed or if the frame size changes
+	/// </summary>
+	/// <param name="frame">video frame (CV_8UC3)</param>
+	/// <returns>area of the frame to analyse</returns>
+	const cv::Rect& Update(const cv::Mat& frame)
+	{
+		if (frame.size() != m_frameSize)
+		{
+			m_frameSize = frame.size();
+			m_area = cv::Rect(cv::Point(0, 0), m_frameSize);
+			m_content = cv::Rect();
+			m_probedFrames = 0;
+		}
+
+		if (m_probedFrames < m_probeFrames)
+		{
+			cv::Rect content = ContentArea(frame);
+			if (!content.empty())
+			{
+				m_content = m_content.empty() ? content : (m_content | content);
+				if (++m_probedFrames == m_probeFrames)
+				{
+					m_area = m_content;
+				}
+			}
+			return m_area;
+		}
+
+		if (!BordersAreBlack(frame))
+		{
+			m_area |= ContentArea(frame);
+		}
+		return m_area;
+	}
+
+	inline const cv::Rect& GetArea() const { return m_area; }
+
+private:
+	//highest channel value of the pixels in the columns from begin to end of the row
+	static uchar MaxValue(const uchar* row, int begin, int end)
+	{
+		uchar max = 0;
+		for (int i = begin * 3; i < end * 3; i++)
+		{
+			max = std::max(max, row[i]);
+		}
+		return max;
+	}
+
+	//bounding box of the pixels that are not black
+	cv::Rect ContentArea(const cv::Mat& frame) const
+	{
+		int top = frame.rows, bottom = -1, left = frame.cols, right = -1;
+		std::mutex areaMutex;
+		cv::parallel_for_(cv::Range(0, frame.rows), [&](const cv::Range& range)
+		{
+			int rangeTop = frame.rows, rangeBottom = -1, rangeLeft = frame.cols, rangeRight = -1;
+			for (int row = range.start; row < range.end; row++)
+			{
+				const uchar* pixels = frame.ptr<uchar>(row);
+				int first = 0, last = frame.cols - 1;
+				while (first < frame.cols && MaxValue(pixels, first, first + 1) <= m_blackThreshold) { first++; }
+				if (first == frame.cols)
+				{
+					continue; //black row
+				}
+				while (MaxValue(pixels, last, last + 1) <= m_blackThreshold) { last--; }
+
+				rangeTop = std::min(rangeTop, row);
+				rangeBottom = row;
+				rangeLeft = std::min(rangeLeft, first);
+				rangeRight = std::max(rangeRight, last);
+			}
+
+			std::lock_guard<std::mutex> lock(areaMutex);
+			top = std::min(top, rangeTop);
+			bottom = std::max(bottom, rangeBottom);
+			left = std::min(left, rangeLeft);
+			right = std::max(right, rangeRight);
+		});
+
+		if (bottom < 0)
+		{
+			return cv::Rect();
+		}
+		return cv::Rect(left, top, right - left + 1, bottom - top + 1);
+	}
+
+	//true if every pixel outside the content area is black
+	bool BordersAreBlack(const cv::Mat& frame) const
+	{
+		std::atomic<bool> black = true;
+		cv::parallel_for_(cv::Range(0, frame.rows), [&](const cv::Range& range)
+		{
+			uchar max = 0;
+			for (int row = range.start; row < range.end && black; row++)
+			{
+				const uchar* pixels = frame.ptr<uchar>(row);
+				if (row < m_area.y || row >= m_area.br().y)
+				{
+					max = std::max(max, MaxValue(pixels, 0, frame.cols));
+				}
+				else
+				{
+					max = std::max(max, MaxValue(pixels, 0, m_area.x));
+					max = std::max(max, MaxValue(pixels, m_area.br().x, frame.cols));
+				}
+
+				if (max > m_blackThreshold)
+				{
+					black = false;
+				}
+			}
+		});
+		return black;
+	}
+
+	int m_blackThreshold;
+	int m_probeFrames;
+	int m_probedFrames = 0;
+	cv::Size m_frameSize;
+	cv::Rect m_content; //content area of the probed frames
+	cv::Rect m_area; //area of the frame to analyse
+};
+
+}
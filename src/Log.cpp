@@ -41,4 +41,11 @@ namespace iris
 	{
 		SetLoggerFile(m_DataLogger, RotatingFileSinkParams(fileName), "%v");
 	}
+
+	std::shared_ptr<spdlog::logger> Log::CreateDataLogger(const char* fileName)
+	{
+		auto dataLogger = std::make_shared<spdlog::logger>("DataLogger", RotatingFileSink(RotatingFileSinkParams(fileName)));
+		dataLogger->set_pattern("%v");
+		return dataLogger;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Frame source that decodes the video through cv::VideoCapture
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "IFrameSource.h"
+#include <opencv2/videoio.hpp>
+
+namespace iris
+{
+
+class OpenCvFrameSource : public IFrameSource
+{
+public:
+	OpenCvFrameSource(const char* sourceVideo) : m_video(sourceVideo) {};
+	virtual ~OpenCvFrameSource() {};
+
+	virtual bool Read(cv::Mat& frame) override { return m_video.read(frame) && !frame.empty(); }
+
+	virtual void Release() override { m_video.release(); }
+
+	inline cv::VideoCapture& GetVideoCapture() { return m_video; }
+
+private:
+	cv::VideoCapture m_video;
+};
+
+}
@@ -9,9 +9,13 @@
 #include "ConfigurationParams.h"
 #include "iris/TotalFlashIncidents.h"
 #include "IFrameManager.h"
+#include "FixedPoint.h"
+#include "ThreadPool.h"
+#include "ExclusionMask.h"
 
 
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <math.h>
 #include <opencv2/features2d.hpp>
@@ -53,9 +57,10 @@ PatternDetection::PatternDetection(Configuration* configuration, const short& fp
     m_patternFrameCount.count.push_back(0);
 
     m_managerIndx = m_frameManager->RegisterManager(m_frameTimeThresh, m_params->timeThreshold);
+    m_gateThreshold = configuration->GetPatternGateThreshold();
     
-    //TODO:: CACULATE CROPPED IMAGE
-    centerPoint = cv::Point(scaleSize.width / 2, scaleSize.height / 2);
+    m_displaySize = frameSize;
+    setFrameArea(cv::Rect(cv::Point(0, 0), frameSize));
 
     int dilation_size = 1;
     m_dilationElement = cv::getStructuringElement(cv::MORPH_RECT,
@@ -68,14 +73,122 @@ PatternDetection::PatternDetection(Configuration* configuration, const short& fp
         cv::Point(erosion_size, erosion_size));
 }
 
+PatternDetection::~PatternDetection()
+{
+    //the workers finish the submitted frames before the workspaces are released
+    m_workerPool.reset();
+}
+
 void PatternDetection::checkFrame(const IrisFrame& irisFrame, const int& framePos, FrameData& data)
 {
-    auto pattern = detectPattern(irisFrame, framePos);
+    //a repeated frame has the same luminance as the last one and the same pattern
+    Pattern pattern = irisFrame.repeatedFrame && m_hasLastPattern ? m_lastPattern : detectPattern(irisFrame, framePos);
+    m_lastPattern = pattern;
+    m_hasLastPattern = true;
 
 #ifdef DEBUG_PATTERN_DETECTION
     cv::destroyAllWindows();
 #endif // DEBUG_PATTERN_DETECTION
 
+    commitPattern(pattern, data, m_frameManager->GetCurrentFrameNum(m_managerIndx), m_frameManager->GetFramesToRemove(m_managerIndx));
+}
+
+void PatternDetection::setWorkers(unsigned int workers)
+{
+    commitFrames(0);
+    m_workerPool.reset();
+    m_workspaces.clear();
+    m_freeWorkspaces.clear();
+
+    if (workers == 0)
+    {
+        return;
+    }
+
+    //each worker runs a whole detection, their spectrum filters do not also use the OpenCV threads
+    m_workerPool = std::make_unique<ThreadPool>(workers);
+    for (unsigned int i = 0; i < workers; i++)
+    {
+        m_workspaces.emplace_back(centerPoint, false);
+        m_workspaces.back().setSize(m_areaScaleSize);
+        m_freeWorkspaces.push_back(&m_workspaces.back());
+    }
+}
+
+void PatternDetection::submitFrame(const IrisFrame& irisFrame, const int& framePos, FrameData& data)
+{
+    //the frame manager values are the ones of this frame, the next frames are added before it is committed
+    PendingFrame pending = { {}, &data, m_frameManager->GetCurrentFrameNum(m_managerIndx), m_frameManager->GetFramesToRemove(m_managerIndx) };
+
+    if (irisFrame.repeatedFrame && m_hasLastPattern)
+    {
+        //a repeated frame has the same luminance as the last one and the same pattern
+        pending.pattern = m_lastPatternResult;
+        m_pendingFrames.push_back(pending);
+        return;
+    }
+
+    //the downscale and the gate depend on the last analysed frame, they run in frame order
+    cv::Mat luminance, luminance_8UC;
+    downscaleLuminance(irisFrame, luminance, luminance_8UC);
+    if (!isGated(luminance))
+    {
+        auto detection = std::make_shared<std::packaged_task<Pattern()>>([this, luminance, luminance_8UC, analysedArea = getAnalysedArea()]() mutable
+        {
+            FourierTransform* workspace;
+            {
+                std::lock_guard<std::mutex> lock(m_workspaceMutex);
+                workspace = m_freeWorkspaces.back();
+                m_freeWorkspaces.pop_back();
+            }
+
+            Pattern pattern = {};
+            try
+            {
+                pattern = findPattern(luminance, luminance_8UC, analysedArea, *workspace);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_workspaceMutex);
+                m_freeWorkspaces.push_back(workspace);
+                throw;
+            }
+
+            std::lock_guard<std::mutex> lock(m_workspaceMutex);
+            m_freeWorkspaces.push_back(workspace);
+            return pattern;
+        });
+        m_lastPatternResult = detection->get_future().share();
+        m_workerPool->Enqueue([detection]() { (*detection)(); });
+    }
+    m_hasLastPattern = true;
+
+    pending.pattern = m_lastPatternResult;
+    m_pendingFrames.push_back(pending);
+}
+
+size_t PatternDetection::commitFrames(size_t maxPending)
+{
+    size_t committed = 0;
+    while (!m_pendingFrames.empty())
+    {
+        PendingFrame& pending = m_pendingFrames.front();
+        if (m_pendingFrames.size() <= maxPending && pending.pattern.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            break;
+        }
+
+        //rethrows the exceptions of the detection
+        m_lastPattern = pending.pattern.get();
+        commitPattern(m_lastPattern, *pending.data, pending.framesInWindow, pending.framesToRemove);
+        m_pendingFrames.pop_front();
+        committed++;
+    }
+    return committed;
+}
+
+void PatternDetection::commitPattern(const Pattern& pattern, FrameData& data, int framesInWindow, int framesToRemove)
+{
     bool harmful = false;
     if (pattern.area >= m_safeArea && pattern.nComponents>= m_params->minStripes && pattern.avgLightLuminance >= 0.25)
     {
@@ -85,21 +198,71 @@ void PatternDetection::checkFrame(const IrisFrame& irisFrame, const int& framePo
     }
 
     m_patternFrameCount.updateCurrent(harmful);
-    checkFrameCount(data);
+    checkFrameCount(data, framesInWindow, framesToRemove);
 }
 
 PatternDetection::Pattern PatternDetection::detectPattern(const IrisFrame& irisFrame, const int& framePos)
 {
-    cv::Mat luminance, luminance_8UC, iftThresh;
-    cv::resize(*irisFrame.luminanceFrame, luminance, scaleSize);
+    cv::Mat luminance, luminance_8UC;
+    downscaleLuminance(irisFrame, luminance, luminance_8UC);
+
+    if (isGated(luminance))
+    {
+        return m_lastPattern;
+    }
+
+    return findPattern(luminance, luminance_8UC, getAnalysedArea(), m_fourierTransform);
+}
+
+void PatternDetection::downscaleLuminance(const IrisFrame& irisFrame, cv::Mat& luminance, cv::Mat& luminance_8UC)
+{
+    if (irisFrame.luminanceFrame->depth() == CV_32S)
+    {
+        //fixed point luminance
+        irisFrame.luminanceFrame->convertTo(luminance, CV_32F, 1.0 / FixedPoint::One);
+        cv::resize(luminance, luminance, m_areaScaleSize);
+    }
+    else
+    {
+        cv::resize(*irisFrame.luminanceFrame, luminance, m_areaScaleSize);
+    }
     
+    const cv::Mat& analysedArea = getAnalysedArea();
+    if (!analysedArea.empty())
+    {
+        //excluded pixels are 0, they would lower the normalization minimum and their edges would add frequencies to the DFT
+        luminance.setTo(cv::mean(luminance, analysedArea), m_excludedArea);
+    }
+
     //normalize luminance values (ensures proper contrast if existing pattern)
     cv::normalize(luminance, luminance_8UC, 0, 255, cv::NORM_MINMAX);
     luminance_8UC.convertTo(luminance_8UC, CV_8UC1);
 
     SHOW_IMG(luminance_8UC, "8bit Luminance Frame"); 
+}
+
+bool PatternDetection::isGated(const cv::Mat& luminance)
+{
+    if (m_gateThreshold <= 0)
+    {
+        return false;
+    }
 
-    if (hasPattern(luminance_8UC, iftThresh))
+    //nearly unchanged frames have the pattern of the last analysed frame, which is also the last pattern. The luminance
+    //is compared before normalization, a brightness or contrast change can make a pattern harmful without changing its shape
+    if (m_hasLastPattern && m_lastAnalysedLuminance.size() == luminance.size()
+        && cv::norm(luminance, m_lastAnalysedLuminance, cv::NORM_L1) < m_gateThreshold / 255.0 * luminance.total())
+    {
+        return true;
+    }
+    luminance.copyTo(m_lastAnalysedLuminance);
+    return false;
+}
+
+PatternDetection::Pattern PatternDetection::findPattern(const cv::Mat& luminance, cv::Mat& luminance_8UC, const cv::Mat& analysedArea, FourierTransform& fourierTransform)
+{
+    cv::Mat iftThresh;
+    if (hasPattern(luminance_8UC, iftThresh, analysedArea, fourierTransform))
     {
         Pattern pattern;
         auto [patternRegionMask, nComponents] = getPatternRegion(iftThresh, luminance_8UC);
@@ -116,10 +279,70 @@ PatternDetection::Pattern PatternDetection::detectPattern(const IrisFrame& irisF
     return { };   
 }
 
-void PatternDetection::checkFrameCount(FrameData& data)
+void PatternDetection::setFrameArea(const cv::Rect& area)
+{
+    //the workers read the center point when their workspaces change size, the submitted frames are finished first
+    for (const PendingFrame& pending : m_pendingFrames)
+    {
+        pending.pattern.wait();
+    }
+
+    m_areaScaleSize = scaleSize;
+    if (area.size() != m_displaySize)
+    {
+        m_areaScaleSize.width = std::max(1, (int)std::lround(area.width * scaleSize.width / (double)m_displaySize.width));
+        m_areaScaleSize.height = std::max(1, (int)std::lround(area.height * scaleSize.height / (double)m_displaySize.height));
+    }
+    centerPoint = cv::Point(m_areaScaleSize.width / 2, m_areaScaleSize.height / 2);
+    m_fourierTransform.setSize(m_areaScaleSize);
+    for (FourierTransform& workspace : m_workspaces)
+    {
+        workspace.setSize(m_areaScaleSize);
+    }
+}
+
+void PatternDetection::setExclusionMask(const ExclusionMask* mask)
+{
+    m_exclusionMask = mask;
+    m_analysedArea = cv::Mat();
+    m_analysedAreaSize = cv::Size();
+}
+
+const cv::Mat& PatternDetection::getAnalysedArea()
 {
-    int framesInHalfSecond = m_frameManager->GetCurrentFrameNum(m_managerIndx);
-    if(m_patternFrameCount.current >= framesInHalfSecond)
+    if (m_exclusionMask == nullptr)
+    {
+        return m_analysedArea;
+    }
+
+    if (m_analysedAreaSize != m_exclusionMask->frameSize || m_analysedArea.size() != m_areaScaleSize)
+    {
+        //the mask is updated after the frame area, it is downscaled again once it has the new size
+        cv::Mat analysedPixels = cv::Mat::zeros(m_exclusionMask->frameSize, CV_8UC1);
+        for (int row = 0; row < analysedPixels.rows; row++)
+        {
+            uchar* pixels = analysedPixels.ptr<uchar>(row);
+            for (const cv::Range& span : m_exclusionMask->spans[row])
+            {
+                std::fill(pixels + span.start, pixels + span.end, 255);
+            }
+        }
+
+        //downscaled pixels with any excluded pixel are also excluded
+        cv::Mat downscaled, analysedArea, excludedArea;
+        cv::resize(analysedPixels, downscaled, m_areaScaleSize, 0, 0, cv::INTER_AREA);
+        cv::compare(downscaled, 255, analysedArea, cv::CMP_EQ);
+        cv::bitwise_not(analysedArea, excludedArea);
+        m_analysedArea = analysedArea;
+        m_excludedArea = excludedArea;
+        m_analysedAreaSize = m_exclusionMask->frameSize;
+    }
+    return m_analysedArea;
+}
+
+void PatternDetection::checkFrameCount(FrameData& data, int framesInWindow, int framesToRemove)
+{
+    if(m_patternFrameCount.current >= framesInWindow)
     {
         data.patternFrameResult = PatternResult::Fail;
         m_isFail = true;
@@ -130,29 +353,32 @@ void PatternDetection::checkFrameCount(FrameData& data)
         data.patternFrameResult = PatternResult::Pass;
     }
 
-    int frameExcess = m_frameManager->GetFramesToRemove(m_managerIndx);
-    for (frameExcess; frameExcess > 0; frameExcess--)
+    for (int frameExcess = framesToRemove; frameExcess > 0; frameExcess--)
     {
         m_patternFrameCount.updatePassed();
     }
 }
 
-bool PatternDetection::hasPattern(const cv::Mat& luminanceFrame, cv::Mat& iftThresh)
+bool PatternDetection::hasPattern(const cv::Mat& luminanceFrame, cv::Mat& iftThresh, const cv::Mat& analysedArea, FourierTransform& fourierTransform)
 {
     //obtain the power spectrum then use it to filter the magnitude
-    FourierTransform ft(centerPoint);
-    FourierTransform::DftComponents dftComps = ft.getPSD(luminanceFrame);
-    cv::Mat peaks = ft.getPeaks(dftComps.powerSpectrum);
-    ft.filterMagnitude(peaks, dftComps.magnitude);
+    FourierTransform::DftComponents& dftComps = fourierTransform.getPSD(luminanceFrame);
+    cv::Mat& peaks = fourierTransform.getPeaks(dftComps.powerSpectrum);
+    fourierTransform.filterSpectrum(peaks, dftComps.spectrum);
 
-    //reconstruct image
-    cv::Mat ift = ft.getIFT(dftComps);
+    //reconstruct image with the size of the frame
+    const cv::Mat& ift = fourierTransform.getIFT(dftComps, luminanceFrame.size());
 
 #ifdef DEBUG_FFT
     SHOW_IMG(ift, "IFT");
 #endif // DEBUG_FFT
 
     iftThresh = highlightPatternArea(ift, luminanceFrame);
+    if (!analysedArea.empty())
+    {
+        //the borders of the excluded areas are not part of a pattern
+        cv::bitwise_and(iftThresh, analysedArea, iftThresh);
+    }
 
     //if the area threshold has not been reached, no harmful pattern exists
     if (cv::countNonZero(iftThresh) < m_diffThreshold)
@@ -162,18 +388,8 @@ bool PatternDetection::hasPattern(const cv::Mat& luminanceFrame, cv::Mat& iftThr
     return true;
 }
 
-cv::Mat PatternDetection::highlightPatternArea(cv::Mat& ift, const cv::Mat& luminanceFrame)
+cv::Mat PatternDetection::highlightPatternArea(const cv::Mat& ift, const cv::Mat& luminanceFrame)
 {
-    if (ift.size() != luminanceFrame.size())
-    {
-        //resize IFT to match size of original frame
-        cv::resize(ift, ift, luminanceFrame.size());
-
-#ifdef DEBUG_IFT
-        SHOW_IMG(ift, "IFT Resize");
-#endif // DEBUG_IFT
-    }
-
     cv::Mat absDiff;
     cv::absdiff(ift, luminanceFrame, absDiff);
 #ifdef DEBUG_IFT
@@ -392,6 +608,22 @@ std::tuple<std::vector<cv::Point>, int> PatternDetection::getSimilarContours(con
     return { contour, similarContours[0].size()};
 }
 
+void PatternDetection::appendState(std::vector<double>& state) const
+{
+    state.push_back(m_patternFrameCount.count.size());
+    state.push_back(m_patternFrameCount.current);
+    for (int value : m_patternFrameCount.count)
+    {
+        state.push_back(value - m_patternFrameCount.passed);
+    }
+
+    state.push_back(m_hasLastPattern);
+    state.push_back(m_lastPattern.area);
+    state.push_back(m_lastPattern.nComponents);
+    state.push_back(m_lastPattern.avgDarkLuminance);
+    state.push_back(m_lastPattern.avgLightLuminance);
+}
+
 bool PatternDetection::isFail()
 {
 	return m_isFail;
@@ -425,103 +657,142 @@ void showContours(const std::vector<std::vector<cv::Point>>& contours, const cv:
 #endif
 
 
-FourierTransform::DftComponents FourierTransform::getPSD(const cv::Mat& src)
+void FourierTransform::setSize(const cv::Size& size)
+{
+    if (size == m_size)
+    {
+        return;
+    }
+    m_size = size;
+
+    // on the border add zero values, only the frame area is written by the next frames
+    cv::Size dftSize(cv::getOptimalDFTSize(size.width), cv::getOptimalDFTSize(size.height));
+    m_padded = cv::Mat::zeros(dftSize, CV_32F);
+    m_real.create(dftSize, CV_32F);
+    m_imag.create(dftSize, CV_32F);
+    m_dftComps.spectrum.create(dftSize, CV_32FC2);
+    m_dftComps.magnitude.create(dftSize, CV_32F);
+    m_dftComps.powerSpectrum.create(dftSize, CV_32F);
+    m_peaks.create(dftSize, CV_8UC1);
+    m_ift.create(dftSize, CV_32F);
+    m_ift8U.create(dftSize, CV_8U);
+    m_output.create(size, CV_8U);
+
+    //the DC removal disk is drawn around the center of the shifted spectrum and moved to the unshifted coefficients once
+    m_dcMask = cv::Mat::zeros(dftSize, CV_8UC1);
+    cv::circle(m_dcMask, centerPoint, 5, 255, -1);
+    fftShift(m_dcMask);
+}
+
+FourierTransform::DftComponents& FourierTransform::getPSD(const cv::Mat& src)
 {
-    cv::Mat dft = getDFT(src);
-    DftComponents dftComps = getDftComponents(dft);
+    getDFT(src);
+    getMagnitude();
     
     //compute PSD
-    dftComps.powerSpectrum = dftComps.magnitude.clone();
-    normalize(dftComps.powerSpectrum, -1.0f, 1.0f);
-    dftComps.powerSpectrum = cv::abs(dftComps.powerSpectrum);
-    dftComps.powerSpectrum = 1 - dftComps.powerSpectrum;
-    cv::pow(dftComps.powerSpectrum, 2, dftComps.powerSpectrum);
-    log(dftComps.powerSpectrum);
-    normalize(dftComps.powerSpectrum, 0, 255);
+    m_dftComps.magnitude.copyTo(m_dftComps.powerSpectrum);
+    normalize(m_dftComps.powerSpectrum, -1.0f, 1.0f);
+    cv::absdiff(m_dftComps.powerSpectrum, cv::Scalar::all(0), m_dftComps.powerSpectrum);
+    cv::subtract(cv::Scalar::all(1), m_dftComps.powerSpectrum, m_dftComps.powerSpectrum);
+    cv::pow(m_dftComps.powerSpectrum, 2, m_dftComps.powerSpectrum);
+    log(m_dftComps.powerSpectrum);
+    normalize(m_dftComps.powerSpectrum, 0, 255);
 
 #ifdef DEBUG_FFT
-    fftShift(dftComps.powerSpectrum);
-    SHOW_IMG(dftComps.powerSpectrum , "PSD");
-    fftShift(dftComps.powerSpectrum);
+    fftShift(m_dftComps.powerSpectrum);
+    SHOW_IMG(m_dftComps.powerSpectrum , "PSD");
+    fftShift(m_dftComps.powerSpectrum);
 #endif // DEBUG_FFT
 
-    return dftComps;
+    return m_dftComps;
 }
 
-cv::Mat FourierTransform::getPeaks(const cv::Mat& psd)
+cv::Mat& FourierTransform::getPeaks(const cv::Mat& psd)
 {
     //threshold peaks
-    cv::Mat threshPSD;
-    psd.convertTo(threshPSD, CV_8UC1);
-    double thresh = cv::threshold(threshPSD, threshPSD, 7, 255, cv::ThresholdTypes::THRESH_OTSU);
+    psd.convertTo(m_peaks, CV_8UC1);
+    double thresh = cv::threshold(m_peaks, m_peaks, 7, 255, cv::ThresholdTypes::THRESH_OTSU);
 
 #ifdef DEBUG_FFT
-    fftShift(threshPSD);
-    SHOW_IMG(threshPSD, "PSD Binary Threshold");
-    fftShift(threshPSD);
+    fftShift(m_peaks);
+    SHOW_IMG(m_peaks, "PSD Binary Threshold");
+    fftShift(m_peaks);
 #endif // DEBUG_FFT
 
-    return threshPSD;
+    return m_peaks;
 }
 
-void FourierTransform::filterMagnitude(cv::Mat& peaks, cv::Mat& magnitude)
+void FourierTransform::filterSpectrum(cv::Mat& peaks, cv::Mat& spectrum)
 {
-    //prepare mask in peaks mat
-    fftShift(peaks);
-    peaks.convertTo(peaks, CV_8UC1);
-    cv::circle(peaks, centerPoint, 5, 0, -1);
-
 #ifdef DEBUG_FFT
-    SHOW_IMG(peaks, "Magnitude mask");
+    cv::Mat magnitudeMask = peaks.clone();
+    magnitudeMask.setTo(0, m_dcMask);
+    fftShift(magnitudeMask);
+    SHOW_IMG(magnitudeMask, "Magnitude mask");
 #endif // DEBUG_FFT
 
-    fftShift(peaks);
+    //remove the peaks outside the DC disk from the coefficients in a single pass, same as removing them from the magnitude
+    auto filterRows = [&](const cv::Range& range)
+    {
+        for (int row = range.start; row < range.end; row++)
+        {
+            const uchar* peak = peaks.ptr<uchar>(row);
+            const uchar* dc = m_dcMask.ptr<uchar>(row);
+            cv::Vec2f* coefficient = spectrum.ptr<cv::Vec2f>(row);
+            for (int col = 0; col < spectrum.cols; col++)
+            {
+                if (peak[col] != 0 && dc[col] == 0)
+                {
+                    coefficient[col] = cv::Vec2f(0, 0);
+                }
+            }
+        }
+    };
 
-    //remove peaks in magnitude with mask
-    magnitude = magnitude.setTo(0, peaks);
+    if (m_parallel)
+    {
+        cv::parallel_for_(cv::Range(0, spectrum.rows), filterRows);
+    }
+    else
+    {
+        filterRows(cv::Range(0, spectrum.rows));
+    }
 }
 
 
-cv::Mat FourierTransform::getIFT(DftComponents dftComps)
+cv::Mat& FourierTransform::getIFT(const DftComponents& dftComps, const cv::Size& size)
 {
-    cv::Mat dft, ift;
-    cv::Mat planes[] = { cv::Mat(), cv::Mat() }; //planes[0] = real, planes[1] = imag
-
-    //recover the complex dft from the magnitude and phase
-    cv::polarToCart(dftComps.magnitude, dftComps.phase, planes[0], planes[1]);
-    cv::merge(planes, 2, dft);
+    //inverse the dft to reconstruct the image, the coefficients of a real image are conjugate symmetric
+    cv::dft(dftComps.spectrum, m_ift, cv::DFT_INVERSE | cv::DFT_REAL_OUTPUT);
+    m_ift.convertTo(m_ift8U, CV_8U, 255.0); // Back to 8-bits
+    if (m_ift8U.size() == size)
+    {
+        return m_ift8U;
+    }
 
-    //inverse the dft to reconstruct the image 
-    cv::dft(dft, ift, cv::DFT_INVERSE | cv::DFT_REAL_OUTPUT);
-    ift.convertTo(ift, CV_8U, 255.0); // Back to 8-bits
-    return ift;
+    //resize IFT to match size of original frame
+    cv::resize(m_ift8U, m_output, size);
+    return m_output;
 }
 
-cv::Mat FourierTransform::getDFT(const cv::Mat& src)
+void FourierTransform::getDFT(const cv::Mat& src)
 {
-    cv::Mat padded;
-    int m = cv::getOptimalDFTSize(src.rows);
-    int n = cv::getOptimalDFTSize(src.cols); // on the border add zero values
-    cv::copyMakeBorder(src, padded, 0, m - src.rows, 0, n - src.cols, cv::BORDER_CONSTANT, cv::Scalar::all(0));
+    setSize(src.size());
 
     //TODO:: needed if using original frame but not if it's the luminance frame
-    padded.convertTo(padded, CV_32F, 1.0 / 255.0); //this allows proper image reconstruction
+    cv::Mat frameArea = m_padded(cv::Rect(0, 0, src.cols, src.rows));
+    src.convertTo(frameArea, CV_32F, 1.0 / 255.0); //this allows proper image reconstruction
 
-    // Add to the expanded another plane with zeros this way the result may fit in the source matrix
-    cv::Mat planes[] = { cv::Mat_<float>(padded), cv::Mat::zeros(padded.size(), CV_32F) };
-    cv::Mat dft;
-    cv::merge(planes, 2, dft);
-    cv::dft(dft, dft, cv::DFT_SCALE | cv::DFT_COMPLEX_OUTPUT);
-    return dft;
+    //real input transform, the complex output has every coefficient so the mask can be applied to the full spectrum
+    cv::dft(m_padded, m_dftComps.spectrum, cv::DFT_SCALE | cv::DFT_COMPLEX_OUTPUT);
 }
 
-FourierTransform::DftComponents FourierTransform::getDftComponents(cv::Mat& dft)
+void FourierTransform::getMagnitude()
 {
-    DftComponents dftComps(dft);
-    cv::Mat planes[2]; //plane[0] = real, plane[1] = imag
-    cv::split(dft, planes);
-    cv::cartToPolar(planes[0], planes[1], dftComps.magnitude, dftComps.phase);
-    return dftComps;
+    //the phase is not needed, the peaks are removed from the complex coefficients
+    cv::Mat planes[] = { m_real, m_imag }; //plane[0] = real, plane[1] = imag
+    cv::split(m_dftComps.spectrum, planes);
+    cv::magnitude(m_real, m_imag, m_dftComps.magnitude);
 }
 
 void FourierTransform::fftShift(cv::Mat& src)
@@ -539,7 +810,7 @@ void FourierTransform::fftShift(cv::Mat& src)
     cv::Mat q3(aux, cv::Rect(cx, cy, cx, cy)); // Bottom-Right
 
     // swap quadrants (Top-Left with Bottom-Right)
-    cv::Mat tmp;
+    cv::Mat& tmp = m_quadrant; //no allocation once it has the quadrant size and type
     q0.copyTo(tmp);
     q3.copyTo(q0);
     tmp.copyTo(q3);
@@ -2,6 +2,10 @@
 
 #pragma once
 #include "PhotosensitivityDetector.h"
+#include <deque>
+#include <memory>
+#include <future>
+#include <mutex>
 #include <opencv2/core.hpp>
 
 namespace iris
@@ -12,6 +16,8 @@ namespace iris
 	struct IrisFrame;
 	struct Result;
 	struct PatternDetectionParams;
+	class ThreadPool;
+	struct ExclusionMask;
 
 #ifdef _DEBUG
 //#define DEBUG_PATTERN_DETECTION
@@ -31,20 +37,112 @@ namespace iris
 #endif // !DEBUG_PATTERN_DETECTION
 
 
+class FourierTransform
+{
+public:
+	struct DftComponents;
+	struct Peak;
+
+	/// <param name="parallel">false to filter the spectrum in the calling thread, for workspaces used by worker threads</param>
+	FourierTransform(cv::Point& center, bool parallel = true) : centerPoint(center), m_parallel(parallel) {};
+
+	/// <summary>
+	/// Allocates the buffers and the DC mask for frames of the given size, they are reused by every frame of that size.
+	/// The center point must be set for the size before
+	/// </summary>
+	void setSize(const cv::Size& size);
+		
+	/// <summary>
+	/// Calculates the DFT of the frame and its power spectrum
+	/// </summary>
+	/// <param name="src">8 bit frame</param>
+	/// <returns>components of the DFT, the buffers are reused by the next frame</returns>
+	DftComponents& getPSD(const cv::Mat& src);
+
+	cv::Mat& getPeaks(const cv::Mat& psd);
+
+	/// <summary>
+	/// Removes the peaks from the complex DFT coefficients, except the ones of the DC disk precomputed for the frame size
+	/// </summary>
+	void filterSpectrum(cv::Mat& peaks, cv::Mat& spectrum);
+
+	/// <summary>
+	/// Reconstructs the 8 bit frame from the filtered DFT coefficients
+	/// </summary>
+	/// <param name="size">size of the reconstructed frame</param>
+	/// <returns>reconstructed frame, the buffer is reused by the next frame</returns>
+	cv::Mat& getIFT(const DftComponents& dftComps, const cv::Size& size);
+
+
+	struct DftComponents
+	{
+		cv::Mat spectrum; //complex DFT coefficients
+		cv::Mat magnitude, powerSpectrum;
+	};
+
+private:
+
+	void getDFT(const cv::Mat& src);
+	void getMagnitude();
+	void fftShift(cv::Mat& src);
+	void log(cv::Mat& src);
+	void normalize(cv::Mat& src, float min, float max);
+	const cv::Point& centerPoint;
+	bool m_parallel; //the spectrum is filtered with the OpenCV threads
+
+	//workspace kept across frames, no memory is allocated while the frame size does not change
+	cv::Size m_size; //size of the input frames
+	cv::Mat m_padded; //input frame padded to the optimal DFT size, the padding is always 0
+	cv::Mat m_real, m_imag; //planes of the DFT coefficients
+	DftComponents m_dftComps;
+	cv::Mat m_peaks; //peaks mask of the power spectrum
+	cv::Mat m_dcMask; //coefficients around the DC term that are never removed, in unshifted positions
+	cv::Mat m_quadrant; //fftShift swap buffer
+	cv::Mat m_ift; //inverse DFT
+	cv::Mat m_ift8U; //8 bit inverse DFT at the padded size
+	cv::Mat m_output; //8 bit inverse DFT at the frame size
+};
+
 class PatternDetection : public  PhotosensitivityDetector
 {
 public:
 	PatternDetection(Configuration* configuration, const short& fps, const cv::Size& frameSize, IFrameManager* frameManager);
+	~PatternDetection();
 
 	//Checks a video frame for harmful patterns
 	void checkFrame(const IrisFrame& irisFrame, const int& framePos, FrameData& data) override;
 
+	//sets the number of worker threads that detect the patterns of submitted frames, 0 to only use checkFrame
+	void setWorkers(unsigned int workers);
+
+	//starts the pattern detection of the frame in the workers, its results are set by commitFrames in frame order.
+	//The frame data must not be moved until then, the frame is downscaled before returning
+	void submitFrame(const IrisFrame& irisFrame, const int& framePos, FrameData& data);
+
+	//sets the results of the submitted frames in frame order until the first frame whose pattern is not ready,
+	//waiting for it while more than maxPending frames are left. Returns the number of committed frames
+	size_t commitFrames(size_t maxPending);
+
+	inline bool hasWorkers() const { return m_workerPool != nullptr; }
+	inline size_t pendingFrames() const { return m_pendingFrames.size(); }
+
 	//returns true if the video is not compliant to the pattern guidelines
 	bool isFail() override;
 
 	//sets the results of the pattern detection
 	void setResult(Result& result) override;
 
+	//sets the area of the display covered by the next frames, pattern areas stay relative to the full display
+	void setFrameArea(const cv::Rect& area);
+
+	//sets the areas of the frames that are not analysed for patterns, null to analyse every pixel. The mask
+	//can change with the frame area
+	void setExclusionMask(const ExclusionMask* mask);
+
+	//appends the pattern frame counts of the time window, relative to its start, and the last pattern. The gate
+	//luminance is not part of the state, the submitted frames must be committed first
+	void appendState(std::vector<double>& state) const;
+
 private:
 
 	struct Pattern
@@ -55,15 +153,38 @@ private:
 		float avgLightLuminance; //average luminance of pattern light components
 	};
 
-	void checkFrameCount(FrameData& data);
+	struct PendingFrame
+	{
+		std::shared_future<Pattern> pattern;
+		FrameData* data;
+		int framesInWindow; //frame manager values when the frame was submitted
+		int framesToRemove;
+	};
+
+	//updates the pattern frame count with the frame pattern and sets the frame results
+	void commitPattern(const Pattern& pattern, FrameData& data, int framesInWindow, int framesToRemove);
+	void checkFrameCount(FrameData& data, int framesInWindow, int framesToRemove);
 	//detects a pattern in a video frame and returns the pattern info
 	Pattern detectPattern(const IrisFrame& irisFrame, const int& framePos);
 
-	//determines whether a video frame has a pattern or not
-	bool hasPattern(const cv::Mat& luminanceFrame, cv::Mat& ift);
+	//downscales the luminance frame to the analysed size and normalizes it to 8 bits, excluded pixels
+	//are set to the mean of the analysed ones
+	void downscaleLuminance(const IrisFrame& irisFrame, cv::Mat& luminance, cv::Mat& luminance8UC);
+
+	//downscaled pixels that have no excluded pixels, empty if there is no exclusion mask
+	const cv::Mat& getAnalysedArea();
+
+	//returns true if the downscaled luminance is nearly unchanged from the last analysed frame, else it becomes the last analysed frame
+	bool isGated(const cv::Mat& luminance);
+
+	//detects a pattern in the downscaled luminance, only reads the detection parameters so workers can call it with their own workspace
+	Pattern findPattern(const cv::Mat& luminance, cv::Mat& luminance8UC, const cv::Mat& analysedArea, FourierTransform& fourierTransform);
+
+	//determines whether a video frame has a pattern or not, only the pixels of the analysed area are part of the pattern
+	bool hasPattern(const cv::Mat& luminanceFrame, cv::Mat& ift, const cv::Mat& analysedArea, FourierTransform& fourierTransform);
 	
 	//applies operations on the inverse Fourier transform to highlight the pattern area
-	cv::Mat highlightPatternArea(cv::Mat& ift, const cv::Mat& luminanceFrame);
+	cv::Mat highlightPatternArea(const cv::Mat& ift, const cv::Mat& luminanceFrame);
 	
 	//obtains the pattern region mask and the number of pattern components
 	std::tuple<cv::Mat, int> getPatternRegion(cv::Mat& otsu, cv::Mat& luminanceFrame);
@@ -139,6 +260,14 @@ private:
 	PatternDetectionParams* m_params;
 	IFrameManager* m_frameManager;
 	Counter m_patternFrameCount;
+	Pattern m_lastPattern = {}; //pattern of the last frame, used again for repeated frames
+	bool m_hasLastPattern = false;
+	float m_gateThreshold = 0; //mean absolute luminance difference (0-255 scale) below which the last pattern is used again, 0 to disable
+	cv::Mat m_lastAnalysedLuminance; //downscaled luminance before normalization of the last frame whose pattern was detected
+	const ExclusionMask* m_exclusionMask = nullptr;
+	cv::Mat m_analysedArea; //downscaled pixels that have no excluded pixels, a new buffer for every mask as workers may still read the last one
+	cv::Mat m_excludedArea; //inverse of the analysed area
+	cv::Size m_analysedAreaSize; //size of the exclusion mask the analysed area was obtained from
 
 	int m_frameTimeThresh;
 	unsigned int m_patternFailFrames;
@@ -156,50 +285,17 @@ private:
 	cv::Mat m_erosionElement;
 	cv::Point centerPoint;
 	cv::Size scaleSize; //downscale the video frame to this size if the resolutions is high enough
+	cv::Size m_displaySize; //full video frame size
+	cv::Size m_areaScaleSize; //size of the analysed frame area downscaled as the full video frame
+	FourierTransform m_fourierTransform{ centerPoint }; //FFT workspace reused by every frame
+
+	std::unique_ptr<ThreadPool> m_workerPool; //detects the patterns of submitted frames
+	std::deque<FourierTransform> m_workspaces; //FFT workspace of each worker
+	std::vector<FourierTransform*> m_freeWorkspaces; //workspaces not used by a running detection
+	std::mutex m_workspaceMutex;
+	std::deque<PendingFrame> m_pendingFrames; //submitted frames in frame order
+	std::shared_future<Pattern> m_lastPatternResult; //pattern of the last submitted frame, used again for repeated frames
 };
 
-class FourierTransform
-{
-public:
-	struct DftComponents;
-	struct Peak;
-
-	FourierTransform(cv::Point& center) : centerPoint(center) {};
-		
-	/// <summary>
-	/// 
-	/// </summary>
-	/// <param name="src"></param>
-	/// <returns></returns>
-	DftComponents getPSD(const cv::Mat& psd);
-
-	cv::Mat getPeaks(const cv::Mat& psd);
-
-	void filterMagnitude(cv::Mat& peaks, cv::Mat& magnitude);
-
-	cv::Mat getIFT(DftComponents dftComps);
-
-
-	struct DftComponents
-	{
-		DftComponents(const cv::Mat& src)
-		{
-			magnitude = cv::Mat(src.rows, src.cols, CV_32FC1);
-			phase = cv::Mat(src.rows, src.cols, CV_32FC1);
-			powerSpectrum = cv::Mat(src.rows, src.cols, CV_32FC1);
-		};
-
-		cv::Mat phase, magnitude, powerSpectrum;
-	};
-
-private:
-
-	cv::Mat getDFT(const cv::Mat& src);
-	DftComponents getDftComponents(cv::Mat& dft);
-	void fftShift(cv::Mat& src);
-	void log(cv::Mat& src);
-	void normalize(cv::Mat& src, float min, float max);
-	const cv::Point& centerPoint;
-};
 
 }
\ No newline at end of file
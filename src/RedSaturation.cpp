@@ -4,30 +4,93 @@
 #include <opencv2/core.hpp>
 #include "opencv2/imgproc.hpp"
 #include "ConfigurationParams.h"
+#include "IrisFrame.h"
+#include "FlashKernels.h"
+#include <atomic>
 
 namespace iris
 {
-	RedSaturation::RedSaturation(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager)
-		: Flash(fps, frameSize, params, frameManager)
+	RedSaturation::RedSaturation(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager, FrameBufferPool* framePool)
+		: Flash(fps, frameSize, params, frameManager, framePool)
 	{
 
 	}
 
 	RedSaturation::~RedSaturation()
 	{
-		ReleaseLastFrame();
-		ReleaseCurrentFrame();
 	}
 
-	void RedSaturation::SetCurrentFrame(cv::Mat* sRgbFrame)
+	void RedSaturation::SetCurrentFrame(const cv::Mat& sRgbFrame)
 	{
-		cv::Mat* frame = new cv::Mat(sRgbFrame->size(), CV_32FC1, cv::Scalar(0));
-		sRgbFrame->forEach<cv::Vec3f>(CalculateRedSaturation(frame));
+		if (m_sparseFramesEnabled)
+		{
+			SetCurrentSparseFrame(sRgbFrame);
+			return;
+		}
+
+		cv::Mat frame = AcquireFrame(sRgbFrame.size());
+		const FlashKernels& kernels = FlashKernels::Get();
+
+		cv::parallel_for_(cv::Range(0, sRgbFrame.rows), [&](const cv::Range& range)
+		{
+			for (int row = range.start; row < range.end; row++)
+			{
+				kernels.redSaturation(sRgbFrame.ptr<float>(row), frame.ptr<float>(row), sRgbFrame.cols);
+			}
+		});
 
-		Flash::ReleaseLastFrame();
 		Flash::SetCurrentFrame(frame);
 	}
 
+	void RedSaturation::SetCurrentSparseFrame(const cv::Mat& sRgbFrame)
+	{
+		//the buffer that is not the current frame holds the last frame, which is no longer needed
+		SparseFrame& frame = m_sparseCurrentFrame == &m_sparseFrames[0] ? m_sparseFrames[1] : m_sparseFrames[0];
+		frame.Reset(sRgbFrame.size());
+		const FlashKernels& kernels = FlashKernels::Get();
+		std::atomic<int> nonZero = 0;
+
+		cv::parallel_for_(cv::Range(0, sRgbFrame.rows), [&](const cv::Range& range)
+		{
+			std::vector<float> redRow(sRgbFrame.cols);
+			int rangeNonZero = 0;
+			for (int row = range.start; row < range.end; row++)
+			{
+				kernels.redSaturation(sRgbFrame.ptr<float>(row), redRow.data(), sRgbFrame.cols);
+				rangeNonZero += frame.SetRow(row, redRow.data());
+			}
+			nonZero += rangeNonZero;
+		});
+
+		const float frameMean = frame.Sum() / sRgbFrame.total();
+		if (nonZero > sRgbFrame.total() * SPARSE_MAX_DENSITY)
+		{
+			//dense frames are compared faster when most pixels are red
+			cv::Mat denseFrame = AcquireFrame(sRgbFrame.size());
+			frame.ToDense(denseFrame);
+			Flash::SetCurrentFrame(denseFrame, frameMean);
+			return;
+		}
+		Flash::SetCurrentFrame(frame, frameMean);
+	}
+
+	void RedSaturation::SetCurrentFrame(const IrisFrame& irisFrame)
+	{
+		if (irisFrame.repeatedFrame)
+		{
+			RepeatCurrentFrame();
+			return;
+		}
+
+		if (irisFrame.redSaturationFrame == nullptr)
+		{
+			SetCurrentFrame(*irisFrame.sRgbFrame);
+			return;
+		}
+
+		Flash::SetCurrentFrame(*irisFrame.redSaturationFrame, irisFrame.redSaturationMean);
+	}
+
 	//// if R / (R + G + B) >= 0.8 => pixel is saturated red
 	//cv::Mat* RedSaturation::RedSaturationValue(cv::Mat channels[])
 	//{
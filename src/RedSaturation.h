@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Flash.h"
+#include "SparseFrame.h"
 #include "opencv2/core/types.hpp"
 
 namespace cv
@@ -13,41 +14,40 @@ namespace cv
 namespace iris
 {
 	class IFrameManager;
+	class FrameBufferPool;
+	struct IrisFrame;
 	struct FlashParams;
 
 	class RedSaturation : public Flash
 	{
 	public:
 
-		RedSaturation(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager);
+		RedSaturation(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager, FrameBufferPool* framePool = nullptr);
 		~RedSaturation();
 
-		void SetCurrentFrame(cv::Mat* sRgbFrame) override;
+		/// <summary>
+		/// Calculates the red saturation of the sRGB frame and sets it as the current frame
+		/// </summary>
+		void SetCurrentFrame(const cv::Mat& sRgbFrame) override;
 
-	private:
+		/// <summary>
+		/// Uses the precomputed red saturation values of the frame if available,
+		/// otherwise they are calculated from the sRGB frame
+		/// </summary>
+		void SetCurrentFrame(const IrisFrame& irisFrame) override;
 
-		struct CalculateRedSaturation
-		{
-			CalculateRedSaturation(cv::Mat* redSaturationMat) { redSat = redSaturationMat; };
-			cv::Mat* redSat = nullptr;
+		/// <summary>
+		/// Stores the red saturation calculated from sRGB frames as runs of non zero values, frames
+		/// with a high proportion of red pixels are still stored as dense frames
+		/// </summary>
+		inline void SetSparseFramesEnabled(bool enabled) { m_sparseFramesEnabled = enabled; }
 
-			void operator()(cv::Vec3f& pixel, const int* position) const
-			{
-				//if R / (R + G + B) >= 0.8 = > pixel is saturated red
-				if (pixel[2] / (pixel[2] + pixel[1] + pixel[0]) >= 0.8f)
-				{
-					//if (R - G - B) * 320 > 20 => value to check for new transitions with frame diff
-					float red = (pixel[2] - pixel[1] - pixel[0]) * 320;
-					
-					//if negative set to 0 (default value is already 0)
-					if (red > 0)
-					{
-						redSat->ptr<float>(position[0])[position[1]] = red;
-					}
+	private:
 
-				} //else pixel is not red saturated (default value is already 0)
-			}
-		};
+		/// <summary>
+		/// Calculates the red saturation of the sRGB frame row by row, only the non zero values are stored
+		/// </summary>
+		void SetCurrentSparseFrame(const cv::Mat& sRgbFrame);
 
 		/// <summary>
 		/// Calculates the red saturation in all the pixels of the frame
@@ -63,5 +63,9 @@ namespace iris
 		//void RedSatCoefficient(cv::Mat* frame, cv::Mat channels[], cv::Mat* redMask);
 
 		FlashParams* m_params = nullptr; //struct with config params
+
+		bool m_sparseFramesEnabled = false;
+		SparseFrame m_sparseFrames[2]; //current and last sparse frames
+		const float SPARSE_MAX_DENSITY = 0.25f; //proportion of non zero values above which the frame is stored as dense values
 	};
 }
@@ -11,42 +11,62 @@ Abstract class for Flash detection
 #include "ConfigurationParams.h"
 #include "IrisFrame.h"
 #include "IFrameManager.h"
+#include "FlashKernels.h"
+#include "FrameHistogram.h"
 
 namespace iris
 {
     cv::Scalar RelativeLuminance::rgbValues(0.0722f, 0.7152f, 0.2126f);
 
-    RelativeLuminance::RelativeLuminance(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager)
-        : Flash(fps, frameSize, params, frameManager)
+    RelativeLuminance::RelativeLuminance(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager, FrameBufferPool* framePool)
+        : Flash(fps, frameSize, params, frameManager, framePool)
     {
     }
 
     RelativeLuminance::~RelativeLuminance()
     {
-        ReleaseLastFrame();
-        ReleaseCurrentFrame();
     }
 
     /// <summary>
     /// Set the new current frame and move the previous one as the last frame.
-    /// in RelativeLuminance this method and class are responsible to release memory for the frame created
+    /// If the frame has no sRGB values, the luminance was already computed (YUV or fused BGR conversion) and is used as it is
     /// </summary>
     /// <param name="sRgbFrame"></param>
     void RelativeLuminance::SetCurrentFrame(const IrisFrame& irisFrame)
     {
-        cv::Mat* frame = new cv::Mat(irisFrame.sRgbFrame->size(), CV_32FC1);
-        irisFrame.sRgbFrame->forEach<cv::Vec3f>(ConvertToRelativeLuminance(frame));
-        
-        ReleaseLastFrame();
-        Flash::SetCurrentFrame(frame);
+        if (irisFrame.repeatedFrame)
+        {
+            RepeatCurrentFrame();
+            return;
+        }
+
+        if (irisFrame.sRgbFrame == nullptr)
+        {
+            Flash::SetCurrentFrame(*irisFrame.luminanceFrame, irisFrame.luminanceMean);
+            return;
+        }
+
+        SetCurrentFrame(*irisFrame.sRgbFrame);
     }
 
-    void RelativeLuminance::SetCurrentFrame(cv::Mat* bgrFrame)
+    float RelativeLuminance::FrameMean(const FrameHistogram& histogram)
     {
-        cv::Mat* frame = new cv::Mat(bgrFrame->size(), CV_32FC1);
-        bgrFrame->forEach<cv::Vec3f>(ConvertToRelativeLuminance(frame));
+        return (float)histogram.LinearMeans().dot(rgbValues);
+    }
+
+    void RelativeLuminance::SetCurrentFrame(const cv::Mat& sRgbFrame)
+    {
+        cv::Mat frame = AcquireFrame(sRgbFrame.size());
+        const FlashKernels& kernels = FlashKernels::Get();
+
+        cv::parallel_for_(cv::Range(0, sRgbFrame.rows), [&](const cv::Range& range)
+        {
+            for (int row = range.start; row < range.end; row++)
+            {
+                kernels.relativeLuminance(sRgbFrame.ptr<float>(row), frame.ptr<float>(row), sRgbFrame.cols);
+            }
+        });
 
-        ReleaseLastFrame();
         Flash::SetCurrentFrame(frame);
     }
 }
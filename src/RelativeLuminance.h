@@ -12,8 +12,10 @@ namespace cv
 namespace iris
 {
 	class IFRameManager;
+	class FrameBufferPool;
 	struct FlashParams;
 	struct IrisFrame;
+	class FrameHistogram;
 	
 	class RelativeLuminance : public Flash
 	{
@@ -23,28 +25,28 @@ namespace iris
 		/// </summary>
 		/// <param name="fps"></param>
 		/// <param name="flashThreshold"></param>
-		RelativeLuminance(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager);
+		RelativeLuminance(short fps, const cv::Size& frameSize, FlashParams* params, IFrameManager* frameManager, FrameBufferPool* framePool = nullptr);
 
 
 		void SetCurrentFrame(const IrisFrame& irisFrame) override;
-		void SetCurrentFrame(cv::Mat* bgrFrame);
+
+		/// <summary>
+		/// Calculates the relative luminance of the sRGB frame and sets it as the current frame
+		/// </summary>
+		void SetCurrentFrame(const cv::Mat& sRgbFrame) override;
+
+		using Flash::FrameMean;
+
+		/// <summary>
+		/// Calculates the average frame luminance from the channel histograms of the video frame,
+		/// without calculating the luminance of every pixel
+		/// </summary>
+		static float FrameMean(const FrameHistogram& histogram);
 		
 		~RelativeLuminance();
 	protected:
 		static cv::Scalar rgbValues;
 
-		struct ConvertToRelativeLuminance 
-		{
-			ConvertToRelativeLuminance(cv::Mat* luminanceMat) { luminance = luminanceMat; };
-			cv::Mat* luminance = nullptr;
-
-			void operator()(cv::Vec3f& pixel, const int* position) const
-			{
-				//Y = 0.0722 * B + 0.7152 * G + 0.2126 * R where B, G and R
-				luminance->ptr<float>(position[0])[position[1]] = 0.0722f * pixel[0] + 0.7152f * pixel[1] + 0.2126f * pixel[2];
-			}
-		};
-
 	private:
 	};
 }
\ No newline at end of file
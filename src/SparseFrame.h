@@ -0,0 +1,141 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Flash values stored as the runs of non zero values of each row, for
+// frames such as red saturation where most pixels are usually 0. Only the
+// non zero values are written, and rows without values in a range can be
+// compared without reading them. Rows are expanded to dense values when
+// they are compared with a dense frame. The row buffers keep their
+// capacity, so no memory is allocated once a frame has been stored.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace iris
+{
+
+class SparseFrame
+{
+public:
+	/// <summary>
+	/// Clears the frame and sets its size, the row buffers are kept
+	/// </summary>
+	void Reset(const cv::Size& size)
+	{
+		m_size = size;
+		m_rows.resize(size.height);
+		for (Row& row : m_rows)
+		{
+			row.runs.clear();
+			row.values.clear();
+			row.sum = 0;
+		}
+	}
+
+	/// <summary>
+	/// Stores the non zero values of the dense row
+	/// </summary>
+	/// <returns>number of non zero values of the row</returns>
+	int SetRow(int row, const float* values)
+	{
+		Row& sparseRow = m_rows[row];
+		sparseRow.runs.clear();
+		sparseRow.values.clear();
+		sparseRow.sum = 0;
+
+		for (int col = 0; col < m_size.width; col++)
+		{
+			if (values[col] == 0)
+			{
+				continue;
+			}
+
+			if (sparseRow.runs.empty() || sparseRow.runs.back().end != col)
+			{
+				sparseRow.runs.push_back({ col, col, (int)sparseRow.values.size() });
+			}
+			sparseRow.runs.back().end++;
+			sparseRow.values.push_back(values[col]);
+			sparseRow.sum += values[col];
+		}
+		return (int)sparseRow.values.size();
+	}
+
+	/// <summary>
+	/// Writes the values of the columns from begin to end of the row, including the zeros
+	/// </summary>
+	void ExpandRow(int row, int begin, int end, float* values) const
+	{
+		std::fill(values, values + (end - begin), 0.0f);
+		for (const Run& run : m_rows[row].runs)
+		{
+			const int runBegin = std::max(begin, run.start), runEnd = std::min(end, run.end);
+			if (runBegin < runEnd)
+			{
+				const float* runValues = m_rows[row].values.data() + run.offset + (runBegin - run.start);
+				std::copy(runValues, runValues + (runEnd - runBegin), values + (runBegin - begin));
+			}
+		}
+	}
+
+	/// <summary>
+	/// Columns between the first and the last non zero values of the row, empty if the row has no values
+	/// </summary>
+	cv::Range Extent(int row) const
+	{
+		const std::vector<Run>& runs = m_rows[row].runs;
+		return runs.empty() ? cv::Range(0, 0) : cv::Range(runs.front().start, runs.back().end);
+	}
+
+	/// <summary>
+	/// Writes every value of the frame (CV_32FC1 of the frame size)
+	/// </summary>
+	void ToDense(cv::Mat& frame) const
+	{
+		cv::parallel_for_(cv::Range(0, m_size.height), [&](const cv::Range& range)
+		{
+			for (int row = range.start; row < range.end; row++)
+			{
+				ExpandRow(row, 0, m_size.width, frame.ptr<float>(row));
+			}
+		});
+	}
+
+	/// <summary>
+	/// Sum of the values of the frame
+	/// </summary>
+	double Sum() const
+	{
+		double sum = 0;
+		for (const Row& row : m_rows)
+		{
+			sum += row.sum;
+		}
+		return sum;
+	}
+
+	inline const cv::Size& Size() const { return m_size; }
+
+private:
+	struct Run
+	{
+		int start; //first column
+		int end; //column after the last one
+		int offset; //index of the first value in the row values
+	};
+
+	struct Row
+	{
+		std::vector<Run> runs;
+		std::vector<float> values; //non zero values of the runs
+		double sum = 0;
+	};
+
+	cv::Size m_size;
+	std::vector<Row> m_rows;
+};
+
+}
@@ -0,0 +1,105 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Fixed size pool of worker threads that run tasks in the order they are
+// enqueued. Each task returns a future the caller can wait on, exceptions
+// thrown by a task are rethrown by the future. The workers are kept alive
+// for the lifetime of the pool so no threads are created per task.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <deque>
+#include <vector>
+#include <thread>
+#include <future>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+namespace iris
+{
+
+class ThreadPool
+{
+public:
+	/// <param name="threads">number of worker threads (at least 1)</param>
+	explicit ThreadPool(unsigned int threads)
+	{
+		threads = threads > 0 ? threads : 1;
+		m_workers.reserve(threads);
+		for (unsigned int i = 0; i < threads; i++)
+		{
+			m_workers.emplace_back([this] { WorkerLoop(); });
+		}
+	}
+
+	/// <summary>
+	/// Waits for the enqueued tasks to finish and joins the workers
+	/// </summary>
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_taskAvailable.notify_all();
+
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// Adds a task to be run by the next available worker
+	/// </summary>
+	/// <returns>future that becomes ready once the task has run</returns>
+	template <typename Task>
+	std::future<void> Enqueue(Task&& task)
+	{
+		std::packaged_task<void()> packagedTask(std::forward<Task>(task));
+		std::future<void> future = packagedTask.get_future();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_tasks.emplace_back(std::move(packagedTask));
+		}
+		m_taskAvailable.notify_one();
+		return future;
+	}
+
+	inline size_t Size() const { return m_workers.size(); }
+
+private:
+	void WorkerLoop()
+	{
+		while (true)
+		{
+			std::packaged_task<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_taskAvailable.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+
+				if (m_tasks.empty())
+				{
+					return; //stopped and no tasks left
+				}
+
+				task = std::move(m_tasks.front());
+				m_tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	std::vector<std::thread> m_workers;
+	std::deque<std::packaged_task<void()>> m_tasks;
+	bool m_stop = false;
+
+	std::mutex m_mutex;
+	std::condition_variable m_taskAvailable;
+};
+
+}
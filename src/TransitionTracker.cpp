@@ -103,4 +103,12 @@ namespace iris
 			m_redExtendedCount.updatePassed();
 		}
 	}
+
+	void TransitionTracker::AppendState(std::vector<double>& state) const
+	{
+		m_luminanceTransitionCount.appendState(state);
+		m_redTransitionCount.appendState(state);
+		m_luminanceExtendedCount.appendState(state);
+		m_redExtendedCount.appendState(state);
+	}
 }
\ No newline at end of file
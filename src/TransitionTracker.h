@@ -54,6 +54,13 @@ namespace iris
 		/// </summary>
 		/// <param name="framePos"> current frame index </param>
 		void UpdateCounters(const int& framePos);
+
+		/// <summary>
+		/// Appends the transition and extended failure counts of the current windows. The counts are relative to the
+		/// start of the windows, so trackers that started at different frames have the same state once their windows are full.
+		/// The incident totals are not part of the state as they do not change the results of the next frames
+		/// </summary>
+		void AppendState(std::vector<double>& state) const;
 	protected:
 
 		struct Counter
@@ -104,6 +111,16 @@ namespace iris
 					current = 0;
 				}
 			}
+
+			void appendState(std::vector<double>& state) const
+			{
+				state.push_back(count.size());
+				state.push_back(current);
+				for (int value : count)
+				{
+					state.push_back(value - passed);
+				}
+			}
 		};
 
 		struct FlashResults //possible flash results
@@ -20,6 +20,24 @@
 #include <opencv2/imgproc.hpp>
 #include "FpsFrameManager.h"
 #include "TimeFrameManager.h"
+#include "FrameQueue.h"
+#include "OpenCvFrameSource.h"
+#include "FFmpegFrameSource.h"
+#include "YuvFrame.h"
+#include "YuvFrameConverter.h"
+#include "BgrFrameConverter.h"
+#include "ConfigurationParams.h"
+#include "ThreadPool.h"
+#include "FrameBufferPool.h"
+#include "FrameHistogram.h"
+#include "FrameChangeTracker.h"
+#include "LetterboxDetector.h"
+#include "ExclusionMask.h"
+#include "RelativeLuminance.h"
+#include <memory>
+#include <thread>
+#include <deque>
+#include <algorithm>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -29,6 +47,93 @@ extern "C" {
 
 namespace iris
 {
+	/// <summary>
+	/// Reads and analyses all the video frames. If queueSize is not 0, frames are read in a separate
+	/// decoder thread that runs up to queueSize frames ahead of the analysis
+	/// </summary>
+	template <typename Frame, typename ReadFn, typename AnalyseFn>
+	static void DecodeAndAnalyse(unsigned int queueSize, ReadFn readFrame, AnalyseFn analyseFrame)
+	{
+		if (queueSize == 0)
+		{
+			Frame frame;
+			while (readFrame(frame))
+			{
+				analyseFrame(frame);
+			}
+			return;
+		}
+
+		FrameQueue<Frame> frameQueue(queueSize);
+		std::exception_ptr decoderError = nullptr;
+		std::thread decoder([&]()
+		{
+			try
+			{
+				Frame decoded;
+				while (readFrame(decoded))
+				{
+					if (!frameQueue.Push(std::move(decoded)))
+					{
+						break; //analysis stopped
+					}
+				}
+			}
+			catch (...)
+			{
+				decoderError = std::current_exception();
+			}
+			frameQueue.Close();
+		});
+
+		try
+		{
+			Frame frame;
+			while (frameQueue.Pop(frame))
+			{
+				analyseFrame(frame);
+			}
+		}
+		catch (...)
+		{
+			frameQueue.Close();
+			decoder.join();
+			throw;
+		}
+		decoder.join();
+
+		if (decoderError != nullptr)
+		{
+			std::rethrow_exception(decoderError);
+		}
+	}
+
+	/// <summary>
+	/// Range of frames of the video analysed by a chunk analyser. Frames from start to begin warm up the
+	/// detectors, only frames from begin to end are part of the chunk result
+	/// </summary>
+	struct AnalysisChunk
+	{
+		int start = 0; //first decoded frame
+		int begin = 0; //first frame of the chunk result
+		int end = -1; //frame after the last frame of the chunk, -1 until the end of the video
+		std::vector<FrameData> frames; //frame data from start
+		std::vector<double> beginState; //detector state after the frame before begin
+		std::vector<double> endState; //detector state after the last frame
+		std::exception_ptr error = nullptr;
+	};
+
+	static void AddFlashIncident(FlashResult frameResult, TotalFlashIncidents& incidents)
+	{
+		switch (frameResult)
+		{
+		case FlashResult::FlashFail: incidents.flashFailFrames += 1; break;
+		case FlashResult::ExtendedFail: incidents.extendedFailFrames += 1; break;
+		case FlashResult::PassWithWarning: incidents.passWithWarningFrames += 1; break;
+		default: break;
+		}
+	}
+
 	VideoAnalyser::VideoAnalyser(Configuration* configuration)
 	{
 		LOG_CORE_WARNING("This output report is for informational purposes only and should not be used as certification or validation of compliance with any legal, regulatory or other requirements");
@@ -40,11 +145,17 @@ namespace iris
 #endif // DEBUG
 	}
 
+	VideoAnalyser::VideoAnalyser(Configuration* configuration, const VideoInfo& videoInfo) 
+		: m_configuration(configuration), m_videoInfo(videoInfo)
+	{
+	}
+
 	VideoAnalyser::~VideoAnalyser()
 	{
+		DeInit();
 	}
 
-	void VideoAnalyser::Init(const std::string& videoPath, bool flagJson)
+	void VideoAnalyser::Init(const std::string& videoPath, bool flagJson, const std::string& resultsName)
 	{
 		m_frameManager = new FpsFrameManager();
 
@@ -56,15 +167,8 @@ namespace iris
 			m_videoInfo.frameSize = cv::Size(m_videoInfo.frameSize.width * resizedFrameProportion, m_videoInfo.frameSize.height * resizedFrameProportion);
 		}
 		
-		m_flashDetection = new FlashDetection(m_configuration, m_videoInfo.fps, m_videoInfo.frameSize, m_frameManager);
-		m_photosensitivityDetector.push_back(m_flashDetection);
-		m_frameSrgbConverter = new EA::EACC::Utils::FrameConverter(m_configuration->GetFrameSrgbConverterParams());
-		m_patternDetection = new PatternDetection(m_configuration, m_videoInfo.fps, m_videoInfo.frameSize, m_frameManager);
+		InitDetectors();
 
-		if (m_configuration->PatternDetectionEnabled())
-		{
-			m_photosensitivityDetector.push_back(m_patternDetection);
-		}
 		std::string videoFileName;
 		if (std::filesystem::exists(videoPath)) 
 		{
@@ -80,8 +184,13 @@ namespace iris
 			videoFileName = videoPath.substr(indexBegin,indexEnd-indexBegin);
 		}
 
+		if (!resultsName.empty())
+		{
+			videoFileName = resultsName;
+		}
+
 		m_frameDataPath = m_configuration->GetResultsPath() + videoFileName + "/framedata.csv";
-		Log::SetDataLoggerFile(m_frameDataPath.c_str());
+		m_dataLogger = Log::CreateDataLogger(m_frameDataPath.c_str());
 
 		if (flagJson)
 		{
@@ -95,6 +204,36 @@ namespace iris
 		
 		LOG_CORE_INFO("Safe Area Proportion: {0}", m_configuration->GetSafeAreaProportion());
 
+		LOG_CORE_INFO("Decode queue size: {0}", m_configuration->GetDecodeQueueSize());
+
+		LOG_CORE_INFO("FFmpeg decoding: {0}", m_configuration->FFmpegDecodingEnabled());
+
+		LOG_CORE_INFO("YUV analysis: {0}", m_configuration->YuvAnalysisEnabled());
+
+		LOG_CORE_INFO("Analysis chunks: {0}", m_configuration->GetAnalysisChunks());
+
+		LOG_CORE_INFO("Parallel detection: {0}", m_configuration->ParallelDetectionEnabled());
+
+		LOG_CORE_INFO("Fused conversion: {0}", m_configuration->FusedConversionEnabled());
+
+		LOG_CORE_INFO("Fixed point: {0}", m_configuration->FixedPointEnabled());
+
+		LOG_CORE_INFO("Duplicate frame detection: {0}", m_configuration->DuplicateFrameDetectionEnabled());
+
+		LOG_CORE_INFO("Tile tracking: {0}", m_configuration->TileTrackingEnabled());
+
+		LOG_CORE_INFO("Letterbox crop: {0}", m_configuration->LetterboxCropEnabled());
+
+		LOG_CORE_INFO("Exclusion areas: {0}", m_exclusionAreas.size());
+
+		LOG_CORE_INFO("Chroma red saturation: {0}", m_configuration->ChromaRedSaturationEnabled());
+
+		LOG_CORE_INFO("Sparse red saturation: {0}", m_configuration->SparseRedSaturationEnabled());
+
+		LOG_CORE_INFO("Pattern gate threshold: {0}", m_configuration->GetPatternGateThreshold());
+
+		LOG_CORE_INFO("Pattern workers: {0}", m_configuration->GetPatternWorkers());
+
 		LOG_CORE_INFO("Write json file: {0}", flagJson);
 	}
 
@@ -115,15 +254,71 @@ namespace iris
 			LOG_CORE_INFO("Resizing frames at: {0}%", resizedFrameProportion * 100);
 			m_videoInfo.frameSize = cv::Size(m_videoInfo.frameSize.width * resizedFrameProportion, m_videoInfo.frameSize.height * resizedFrameProportion);
 		}
-		m_flashDetection = new FlashDetection(m_configuration, m_videoInfo.fps, m_videoInfo.frameSize, m_frameManager);
+		InitDetectors();
+
+		if (m_configuration->GetRealTimeSkipThreshold() > 0)
+		{
+			m_frameHistogram = new FrameHistogram(m_configuration->GetFrameSrgbConverterParams()->values);
+			LOG_CORE_INFO("Real time skip threshold: {0}", m_configuration->GetRealTimeSkipThreshold());
+		}
+	}
+
+	void VideoAnalyser::InitDetectors()
+	{
+		m_framePool = new FrameBufferPool(m_videoInfo.frameSize);
+		m_flashDetection = new FlashDetection(m_configuration, m_videoInfo.fps, m_videoInfo.frameSize, m_frameManager, m_framePool);
 		m_photosensitivityDetector.push_back(m_flashDetection);
 		m_frameSrgbConverter = new EA::EACC::Utils::FrameConverter(m_configuration->GetFrameSrgbConverterParams());
+		m_yuvFrameConverter = new YuvFrameConverter(m_configuration->GetFrameSrgbConverterParams());
+		m_yuvFrameConverter->SetChromaRedSaturation(m_configuration->ChromaRedSaturationEnabled());
+		m_bgrFrameConverter = new BgrFrameConverter(m_configuration->GetFrameSrgbConverterParams());
 		m_patternDetection = new PatternDetection(m_configuration, m_videoInfo.fps, m_videoInfo.frameSize, m_frameManager);
 
+		if (m_configuration->DuplicateFrameDetectionEnabled() || m_configuration->TileTrackingEnabled())
+		{
+			m_frameChangeTracker = new FrameChangeTracker();
+		}
+		if (m_configuration->TileTrackingEnabled())
+		{
+			m_frameTiles = new FrameTiles();
+		}
+
+		m_frameArea = cv::Rect(cv::Point(0, 0), m_videoInfo.frameSize);
+		if (m_configuration->LetterboxCropEnabled() && !m_configuration->YuvAnalysisEnabled())
+		{
+			//borders of near black pixels, the content area is obtained from the first 2 seconds with content
+			m_letterboxDetector = new LetterboxDetector(4, m_videoInfo.fps * 2);
+		}
+
+		//exclusion areas are given in video pixels, frames may be resized
+		float areaScale = m_configuration->FrameResizeEnabled() ? m_configuration->GetFrameResizeProportion() : 1.0f;
+		for (const std::vector<int>& area : m_configuration->GetExclusionAreas())
+		{
+			if (area.size() != 4)
+			{
+				LOG_CORE_WARNING("Exclusion area ignored, areas must be [x, y, width, height] rectangles");
+				continue;
+			}
+			m_exclusionAreas.emplace_back(cvRound(area[0] * areaScale), cvRound(area[1] * areaScale), cvRound(area[2] * areaScale), cvRound(area[3] * areaScale));
+		}
+
+		if (!m_exclusionAreas.empty() && !m_configuration->YuvAnalysisEnabled())
+		{
+			m_exclusionMask = new ExclusionMask(m_frameArea.size(), m_exclusionAreas);
+			m_bgrFrameConverter->SetExclusionMask(m_exclusionMask);
+			m_flashDetection->setExclusionMask(m_exclusionMask);
+			m_patternDetection->setExclusionMask(m_exclusionMask);
+		}
+
 		if (m_configuration->PatternDetectionEnabled())
 		{
 			m_photosensitivityDetector.push_back(m_patternDetection);
 		}
+
+		if (m_configuration->ParallelDetectionEnabled() && m_photosensitivityDetector.size() > 1)
+		{
+			m_detectorPool = new ThreadPool(m_photosensitivityDetector.size() - 1);
+		}
 	}
 
 	void VideoAnalyser::DeInit()
@@ -140,29 +335,73 @@ namespace iris
 		{
 			delete m_frameSrgbConverter; m_frameSrgbConverter = nullptr;
 		}
+		if (m_yuvFrameConverter != nullptr)
+		{
+			delete m_yuvFrameConverter; m_yuvFrameConverter = nullptr;
+		}
+		if (m_bgrFrameConverter != nullptr)
+		{
+			delete m_bgrFrameConverter; m_bgrFrameConverter = nullptr;
+		}
+		if (m_detectorPool != nullptr)
+		{
+			delete m_detectorPool; m_detectorPool = nullptr;
+		}
+		if (m_framePool != nullptr)
+		{
+			delete m_framePool; m_framePool = nullptr;
+		}
+		if (m_frameHistogram != nullptr)
+		{
+			delete m_frameHistogram; m_frameHistogram = nullptr;
+		}
+		if (m_frameChangeTracker != nullptr)
+		{
+			delete m_frameChangeTracker; m_frameChangeTracker = nullptr;
+		}
+		if (m_frameTiles != nullptr)
+		{
+			delete m_frameTiles; m_frameTiles = nullptr;
+		}
+		if (m_letterboxDetector != nullptr)
+		{
+			delete m_letterboxDetector; m_letterboxDetector = nullptr;
+		}
+		if (m_exclusionMask != nullptr)
+		{
+			delete m_exclusionMask; m_exclusionMask = nullptr;
+		}
+		m_exclusionAreas.clear();
 		if (m_frameManager != nullptr)
 		{
 			delete m_frameManager; m_frameManager = nullptr;
 		}
 		m_photosensitivityDetector.clear();
+		if (m_dataLogger != nullptr)
+		{
+			//frame data of an analysis stopped by an error is also written
+			m_dataLogger->flush();
+			m_dataLogger.reset();
+		}
 	}
 
-	void VideoAnalyser::AnalyseVideo(bool flagJson, const char* sourceVideo)
+	void VideoAnalyser::AnalyseVideo(bool flagJson, const char* sourceVideo, Result* videoResult, const char* resultsName)
 	{
-		cv::VideoCapture video(sourceVideo);
 		std::string videoPath(sourceVideo);
+		std::unique_ptr<IFrameSource> video = OpenFrameSource(sourceVideo);
 
-		if (VideoIsOpen(sourceVideo, video))
+		if (video != nullptr)
 		{
-			Init(videoPath, flagJson);
-			SetOptimalCvThreads(m_videoInfo.frameSize);
-			cv::Mat frame;
-			video.read(frame);
+			Init(videoPath, flagJson, resultsName != nullptr ? resultsName : "");
+			if (m_optimalCvThreads)
+			{
+				SetOptimalCvThreads(m_videoInfo.frameSize);
+			}
 
 			unsigned int numFrames = 0;
 			unsigned int lastPercentage = 0;
 
-			LOG_DATA_INFO(FrameData().CsvColumns());
+			m_dataLogger->info(FrameData().CsvColumns());
 			LOG_CORE_INFO("Video analysis started");
 			
 			auto start = std::chrono::steady_clock::now();
@@ -176,23 +415,12 @@ namespace iris
 				nonPassData.reserve(m_videoInfo.frameCount * 0.25); //reserve at least one quarter of frames
 			}
 
-			while (!frame.empty())
+			auto processFrameData = [&](FrameData& data)
 			{
-				FrameData data(numFrames + 1, 1000.0 * (double)numFrames / m_videoInfo.fps);
-				if (m_configuration->FrameResizeEnabled())
-				{
-					cv::resize(frame, frame, m_videoInfo.frameSize);
-				}
-				AnalyseFrame(frame, numFrames, data);
-				
-				video.read(frame); //obtain new frame
-
 				UpdateProgress(numFrames, m_videoInfo.frameCount, lastPercentage);
 				numFrames++;
 
-				LOG_DATA_INFO(data.ToCSV());
-
-				FLUSH_DATA_LOGGER();
+				m_dataLogger->info(data.ToCSV());
 
 				if (flagJson)
 				{
@@ -203,7 +431,68 @@ namespace iris
 						nonPassData.push_back(data);
 					}
 				}
+			};
+
+			std::vector<FrameData> chunkFrames;
+			bool chunkAnalysis = m_configuration->GetAnalysisChunks() > 1 && AnalyseChunks(sourceVideo, chunkFrames);
+
+			//frames wait in the pending queue until their pattern results are committed in frame order
+			std::deque<FrameData> pendingFrames;
+			unsigned int analysedFrames = 0;
+			unsigned int patternWorkers = m_configuration->PatternDetectionEnabled() && !chunkAnalysis ? m_configuration->GetPatternWorkers() : 0;
+			if (patternWorkers > 0)
+			{
+				//patterns are detected by the pattern workers instead of with the other detectors
+				m_photosensitivityDetector.erase(std::remove(m_photosensitivityDetector.begin(), m_photosensitivityDetector.end(), m_patternDetection), m_photosensitivityDetector.end());
+				if (m_detectorPool != nullptr && m_photosensitivityDetector.size() < 2)
+				{
+					delete m_detectorPool; m_detectorPool = nullptr;
+				}
+				m_patternDetection->setWorkers(patternWorkers);
+			}
+
+			auto processCommittedFrames = [&](size_t committed)
+			{
+				for (; committed > 0; committed--)
+				{
+					processFrameData(pendingFrames.front());
+					pendingFrames.pop_front();
+				}
+			};
+
+			auto analyseFrame = [&](auto& frame)
+			{
+				FrameData& data = pendingFrames.emplace_back(analysedFrames + 1, 1000.0 * (double)analysedFrames / m_videoInfo.fps);
+				AnalyseFrame(frame, analysedFrames, data);
+				analysedFrames++;
+
+				//the decoder is only stalled once every worker has two frames to detect
+				processCommittedFrames(patternWorkers > 0 ? m_patternDetection->commitFrames(patternWorkers * 2) : pendingFrames.size());
+			};
+
+			unsigned int queueSize = m_configuration->GetDecodeQueueSize();
+			if (chunkAnalysis)
+			{
+				for (FrameData& data : chunkFrames)
+				{
+					processFrameData(data);
+				}
+			}
+			else if (m_configuration->YuvAnalysisEnabled())
+			{
+				FFmpegFrameSource& ffmpegSource = static_cast<FFmpegFrameSource&>(*video);
+				DecodeAndAnalyse<YuvFrame>(queueSize,
+					[&](YuvFrame& frame) { return ReadFrame(ffmpegSource, frame); },
+					[&](YuvFrame& frame) { analyseFrame(frame); });
+			}
+			else
+			{
+				DecodeAndAnalyse<cv::Mat>(queueSize,
+					[&](cv::Mat& frame) { return ReadFrame(*video, frame); },
+					[&](cv::Mat& frame) { analyseFrame(frame); });
 			}
+			processCommittedFrames(m_patternDetection->commitFrames(0));
+			m_dataLogger->flush();
 
 			auto end = std::chrono::steady_clock::now();
 			LOG_CORE_INFO("Video analysis ended");
@@ -211,15 +500,22 @@ namespace iris
 			LOG_CORE_INFO("Elapsed time: {0} ms", elapsedTime);
 
 			Result result;
-			m_flashDetection->setResult(result);
+			if (chunkAnalysis)
+			{
+				SetResult(chunkFrames, result);
+			}
+			else
+			{
+				m_flashDetection->setResult(result);
 
-			if (m_patternDetection != nullptr) { m_patternDetection->setResult(result); }
+				if (m_patternDetection != nullptr) { m_patternDetection->setResult(result); }
+			}
 
-			if (m_flashDetection->isFail() || m_patternDetection->isFail())
+			if (result.OverallResult == AnalysisResult::Fail)
 			{
 				LOG_CORE_CRITICAL("Video Overall Result: FAIL");
 			}
-			else if (m_flashDetection->isWarning())
+			else if (result.OverallResult == AnalysisResult::PassWithWarning)
 			{
 				LOG_CORE_WARNING("Video Overall Result: PASS WITH WARNING");
 			}
@@ -228,33 +524,523 @@ namespace iris
 				LOG_CORE_INFO("Video Overall Result: PASS");
 			}
 
+			result.VideoLen = m_videoInfo.duration * 1000;
+			result.AnalysisTime = elapsedTime;
+			result.TotalFrame = m_videoInfo.frameCount;
+
 			if (flagJson)
 			{	
-				result.VideoLen = m_videoInfo.duration * 1000;
-				result.AnalysisTime = elapsedTime;
-				result.TotalFrame = m_videoInfo.frameCount;
 				SerializeResults(result, lineGraphData, nonPassData);
 			}
 
+			if (videoResult != nullptr)
+			{
+				*videoResult = result;
+			}
+
 			DeInit();
+
+			video->Release();
+		}
+	}
+
+	std::unique_ptr<IFrameSource> VideoAnalyser::OpenFrameSource(const char* sourceVideo)
+	{
+		if (m_configuration->FFmpegDecodingEnabled() || m_configuration->YuvAnalysisEnabled())
+		{
+			//frames are downscaled by the decoder when frame resize is enabled
+			float outputScale = m_configuration->FrameResizeEnabled() ? m_configuration->GetFrameResizeProportion() : 1.0f;
+
+			std::unique_ptr<FFmpegFrameSource> frameSource = std::make_unique<FFmpegFrameSource>(m_configuration->GetDecoderThreads());
+			if (!frameSource->Open(sourceVideo, outputScale))
+			{
+				LOG_CORE_ERROR("Video: {0} could not be opened\nInformation is missing or corrupt", sourceVideo);
+				throw std::runtime_error("Video: " + std::string(sourceVideo) + "could not be opened\nInformation is missing or corrupt");
+			}
+
+			m_videoInfo.fps = frameSource->GetFps();
+			m_videoInfo.frameCount = frameSource->GetFrameCount();
+			m_videoInfo.frameSize = frameSource->GetFrameSize();
+			m_videoInfo.duration = m_videoInfo.frameCount / (float)m_videoInfo.fps;
+			LogVideoInfo(sourceVideo);
+			return frameSource;
+		}
+
+		std::unique_ptr<OpenCvFrameSource> frameSource = std::make_unique<OpenCvFrameSource>(sourceVideo);
+		VideoIsOpen(sourceVideo, frameSource->GetVideoCapture());
+		return frameSource;
+	}
+
+	bool VideoAnalyser::ReadFrame(IFrameSource& video, cv::Mat& frame)
+	{
+		if (!video.Read(frame))
+		{
+			return false;
+		}
+
+		//frames may already be resized by the decoder
+		if (m_configuration->FrameResizeEnabled() && frame.size() != m_videoInfo.frameSize)
+		{
+			cv::resize(frame, frame, m_videoInfo.frameSize);
+		}
+		return true;
+	}
+
+	bool VideoAnalyser::ReadFrame(FFmpegFrameSource& video, YuvFrame& frame)
+	{
+		if (!video.Read(frame))
+		{
+			return false;
+		}
+
+		if (m_configuration->FrameResizeEnabled() && frame.size() != m_videoInfo.frameSize)
+		{
+			cv::Size chromaSize((m_videoInfo.frameSize.width + 1) / 2, (m_videoInfo.frameSize.height + 1) / 2);
+			cv::resize(frame.y, frame.y, m_videoInfo.frameSize, 0, 0, cv::INTER_AREA);
+			cv::resize(frame.u, frame.u, chromaSize, 0, 0, cv::INTER_AREA);
+			if (frame.layout == YuvFrame::Layout::I420)
+			{
+				cv::resize(frame.v, frame.v, chromaSize, 0, 0, cv::INTER_AREA);
+			}
+		}
+		return true;
+	}
+
+	bool VideoAnalyser::RepeatsAnalysedFrame(const cv::Mat& frame, unsigned int frameIndex)
+	{
+		m_frameHistogram->Calculate(frame);
+		//means of the full video frame, the black borders of letterboxed frames are not part of the frame
+		float luminanceMean = RelativeLuminance::FrameMean(*m_frameHistogram) * m_frameAreaProportion;
+		float redMean = m_frameHistogram->LinearMeans()[2] * m_frameAreaProportion;
+
+		//the red channel is also compared as red flashes can keep the luminance constant
+		float threshold = m_configuration->GetRealTimeSkipThreshold();
+		if (frameIndex > 0 && std::abs(luminanceMean - m_analysedLuminanceMean) < threshold && std::abs(redMean - m_analysedRedMean) < threshold)
+		{
+			return true;
 		}
 
-		video.release();
+		//compared against the last analysed frame, slow changes are not skipped once they add up to the threshold
+		m_analysedLuminanceMean = luminanceMean;
+		m_analysedRedMean = redMean;
+		return false;
 	}
 
-	void VideoAnalyser::AnalyseFrame(cv::Mat& frame, unsigned int& frameIndex, FrameData& data)
+	const cv::Rect& VideoAnalyser::UpdateFrameArea(const cv::Mat& frame)
 	{
-		IrisFrame irisFrame(&(frame), m_frameSrgbConverter->Convert(frame), data);
+		const cv::Rect& area = m_letterboxDetector->Update(frame);
+		if (area != m_frameArea)
+		{
+			LOG_CORE_DEBUG("Analysed frame area: {0}x{1} at ({2}, {3})", area.width, area.height, area.x, area.y);
+			m_flashDetection->setFrameArea(area);
+			m_patternDetection->setFrameArea(area);
+			m_frameArea = area;
+			m_frameAreaProportion = area.area() / (float)frame.total();
+
+			if (m_exclusionMask != nullptr)
+			{
+				std::vector<cv::Rect> areaExclusions;
+				for (const cv::Rect& exclusion : m_exclusionAreas)
+				{
+					areaExclusions.push_back(exclusion - area.tl());
+				}
+				*m_exclusionMask = ExclusionMask(area.size(), areaExclusions);
+			}
+		}
+		return area;
+	}
+
+	void VideoAnalyser::AnalyseFrame(cv::Mat& videoFrame, unsigned int& frameIndex, FrameData& data)
+	{
+		//letterboxed frames are analysed inside their black borders, the borders have no flash values
+		cv::Mat frame = m_letterboxDetector != nullptr ? videoFrame(UpdateFrameArea(videoFrame)) : videoFrame;
+
+		//frames whose means rule out a transition in real time, or exact repeats of the last frame, are
+		//analysed with the flash and pattern results of the last analysed frame. The tracker only keeps the
+		//frames that are converted, so the changed tiles are relative to the last flash values
+		if ((m_frameHistogram != nullptr && RepeatsAnalysedFrame(frame, frameIndex))
+			|| (m_frameChangeTracker != nullptr && (m_frameTiles != nullptr ? m_frameChangeTracker->IsRepeated(frame, *m_frameTiles) : m_frameChangeTracker->IsRepeated(frame))))
+		{
+			AnalyseRepeatedFrame(&frame, frameIndex, data);
+			return;
+		}
+
+		if (m_configuration->FusedConversionEnabled() || m_configuration->FixedPointEnabled() || m_frameTiles != nullptr || m_exclusionMask != nullptr)
+		{
+			//luminance, red saturation and their means are computed in a single pass, no sRGB frame is needed
+			const bool fixedPoint = m_configuration->FixedPointEnabled();
+			cv::Mat luminanceFrame = m_framePool->Acquire(frame.size(), fixedPoint ? CV_32SC1 : CV_32FC1);
+			cv::Mat redSaturationFrame = m_framePool->Acquire(frame.size(), fixedPoint ? CV_32SC1 : CV_32FC1);
+
+			IrisFrame irisFrame(&frame, data);
+			if (m_frameTiles != nullptr)
+			{
+				//only the changed tiles are converted, the rest are copied from the current flash values
+				const cv::Mat& lastLuminance = m_flashDetection->getLuminanceFrame();
+				const cv::Mat& lastRedSaturation = m_flashDetection->getRedSaturationFrame();
+				if (fixedPoint)
+				{
+					m_bgrFrameConverter->ConvertFixed(frame, *m_frameTiles, &lastLuminance, &lastRedSaturation, luminanceFrame, redSaturationFrame, irisFrame.luminanceMean, irisFrame.redSaturationMean);
+				}
+				else
+				{
+					m_bgrFrameConverter->Convert(frame, *m_frameTiles, &lastLuminance, &lastRedSaturation, luminanceFrame, redSaturationFrame, irisFrame.luminanceMean, irisFrame.redSaturationMean);
+				}
+				irisFrame.changedTiles = m_frameTiles;
+			}
+			else if (fixedPoint)
+			{
+				m_bgrFrameConverter->ConvertFixed(frame, luminanceFrame, redSaturationFrame, irisFrame.luminanceMean, irisFrame.redSaturationMean);
+			}
+			else
+			{
+				m_bgrFrameConverter->Convert(frame, luminanceFrame, redSaturationFrame, irisFrame.luminanceMean, irisFrame.redSaturationMean);
+			}
+			irisFrame.luminanceFrame = &luminanceFrame;
+			irisFrame.redSaturationFrame = &redSaturationFrame;
+
+			m_frameManager->AddFrame(data);
+
+			m_flashDetection->setLuminance(irisFrame);
+			CheckFrame(irisFrame, frameIndex, data);
+			return;
+		}
+
+		cv::Mat sRgbFrame = m_framePool->Acquire(frame.size(), CV_32FC3);
+		m_frameSrgbConverter->Convert(frame, sRgbFrame);
+		IrisFrame irisFrame(&frame, &sRgbFrame, data);
 
 		m_frameManager->AddFrame(data);
 
 		m_flashDetection->setLuminance(irisFrame);
-		for (auto detector : m_photosensitivityDetector)
+		CheckFrame(irisFrame, frameIndex, data);
+	}
+
+	void VideoAnalyser::AnalyseFrame(YuvFrame& frame, unsigned int& frameIndex, FrameData& data)
+	{
+		if (m_frameChangeTracker != nullptr && (m_frameTiles != nullptr ? m_frameChangeTracker->IsRepeated(frame, *m_frameTiles) : m_frameChangeTracker->IsRepeated(frame)))
+		{
+			AnalyseRepeatedFrame(nullptr, frameIndex, data);
+			return;
+		}
+
+		//luminance and red saturation are computed directly, FlashDetection keeps them until they are no longer needed
+		IrisFrame irisFrame(nullptr, data);
+		cv::Mat luminanceFrame, redSaturationFrame;
+		if (m_configuration->FixedPointEnabled())
+		{
+			luminanceFrame = m_framePool->Acquire(frame.size(), CV_32SC1);
+			redSaturationFrame = m_framePool->Acquire(m_yuvFrameConverter->GetRedSaturationSize(frame), CV_32SC1);
+			m_yuvFrameConverter->ConvertFixed(frame, luminanceFrame, redSaturationFrame, irisFrame.luminanceMean, irisFrame.redSaturationMean);
+		}
+		else
 		{
-			detector->checkFrame(irisFrame, frameIndex, data);
+			luminanceFrame = m_framePool->Acquire(frame.size(), CV_32FC1);
+			redSaturationFrame = m_framePool->Acquire(m_yuvFrameConverter->GetRedSaturationSize(frame), CV_32FC1);
+			m_yuvFrameConverter->Convert(frame, luminanceFrame, redSaturationFrame);
 		}
 
-		irisFrame.Release();
+		//the changed pixels are only counted in the tiles that changed from the last frame
+		if (m_frameTiles != nullptr)
+		{
+			irisFrame.changedTiles = m_frameTiles;
+		}
+
+		irisFrame.luminanceFrame = &luminanceFrame;
+		irisFrame.redSaturationFrame = &redSaturationFrame;
+
+		m_frameManager->AddFrame(data);
+
+		m_flashDetection->setLuminance(irisFrame);
+		CheckFrame(irisFrame, frameIndex, data);
+	}
+
+	void VideoAnalyser::AnalyseRepeatedFrame(const cv::Mat* frame, unsigned int& frameIndex, FrameData& data)
+	{
+		//no changed pixels and the same frame means, the flash values are not calculated again
+		IrisFrame irisFrame(frame, data);
+		irisFrame.repeatedFrame = true;
+
+		m_frameManager->AddFrame(data);
+
+		m_flashDetection->setLuminance(irisFrame);
+		CheckFrame(irisFrame, frameIndex, data);
+	}
+
+	bool VideoAnalyser::AnalyseChunks(const char* sourceVideo, std::vector<FrameData>& frames)
+	{
+		//chunks seek with FFmpeg, the frames decoded and resized by OpenCV would not match the ones of a sequential run
+		if (!m_configuration->FFmpegDecodingEnabled() && !m_configuration->YuvAnalysisEnabled())
+		{
+			LOG_CORE_WARNING("Analysis chunks need FFmpeg decoding, the video is analysed sequentially");
+			return false;
+		}
+
+		//the pattern gate, the letterbox area and the last frame of the change tracker can depend on any earlier frame,
+		//a chunk detector would not converge with the sequential one after a warm-up window
+		if (m_configuration->GetPatternGateThreshold() > 0 || m_configuration->LetterboxCropEnabled()
+			|| m_configuration->DuplicateFrameDetectionEnabled() || m_configuration->TileTrackingEnabled())
+		{
+			LOG_CORE_WARNING("Analysis chunks are not compatible with the pattern gate, letterbox crop, duplicate frame detection or tile tracking, the video is analysed sequentially");
+			return false;
+		}
+
+		//frames needed to fill the 1s transition window, the 5s extended failure window and the pattern time window
+		int warmUpFrames = m_videoInfo.fps * (7 + m_configuration->GetPatternDetectionParams()->timeThreshold) + 2;
+
+		//every chunk decodes a warm-up window before its first frame, chunks are at least twice as long
+		int chunkCount = std::min((int)m_configuration->GetAnalysisChunks(), m_videoInfo.frameCount / (2 * warmUpFrames));
+		if (chunkCount < 2)
+		{
+			LOG_CORE_INFO("Video is too short to be analysed in chunks");
+			return false;
+		}
+
+		std::vector<AnalysisChunk> chunks(chunkCount);
+		for (int i = 0; i < chunkCount; i++)
+		{
+			chunks[i].begin = (long long)i * m_videoInfo.frameCount / chunkCount;
+			chunks[i].start = std::max(0, chunks[i].begin - warmUpFrames);
+			chunks[i].end = i + 1 < chunkCount ? (long long)(i + 1) * m_videoInfo.frameCount / chunkCount : -1;
+		}
+
+		LOG_CORE_INFO("Analysing video in {0} chunks", chunkCount);
+
+		std::vector<std::thread> chunkThreads;
+		for (AnalysisChunk& chunk : chunks)
+		{
+			chunkThreads.emplace_back([this, sourceVideo, &chunk]()
+			{
+				try
+				{
+					AnalyseChunk(sourceVideo, chunk);
+				}
+				catch (...)
+				{
+					chunk.error = std::current_exception();
+				}
+			});
+		}
+
+		for (std::thread& chunkThread : chunkThreads)
+		{
+			chunkThread.join();
+		}
+
+		for (AnalysisChunk& chunk : chunks)
+		{
+			if (chunk.error != nullptr)
+			{
+				std::rethrow_exception(chunk.error);
+			}
+		}
+
+		//merge the chunks in order, a chunk is only appended once its detector state before its first frame is the
+		//state of the previous chunk after its last frame. The previous chunk has the state of a sequential run,
+		//so the frames of the chunk are the ones of a sequential run. Otherwise it is analysed again from an earlier frame
+		frames.reserve(m_videoInfo.frameCount);
+		const std::vector<double>* lastState = nullptr;
+		for (AnalysisChunk& chunk : chunks)
+		{
+			while (chunk.start > 0 && chunk.beginState != *lastState)
+			{
+				//the warm-up frames are analysed again in this thread, a video whose detectors do not converge
+				//ends up being analysed sequentially up to the chunk
+				chunk.start = std::max(0, chunk.begin - 2 * (chunk.begin - chunk.start));
+				LOG_CORE_WARNING("Chunk at frame {0} has not converged, analysing again from frame {1}", chunk.begin, chunk.start);
+				AnalyseChunk(sourceVideo, chunk);
+			}
+			lastState = &chunk.endState;
+
+			for (int frame = frames.size(); frame < chunk.start + (int)chunk.frames.size(); frame++)
+			{
+				frames.push_back(std::move(chunk.frames[frame - chunk.start]));
+			}
+			chunk.frames.clear();
+		}
+
+		return true;
+	}
+
+	void VideoAnalyser::AnalyseChunk(const char* sourceVideo, AnalysisChunk& chunk)
+	{
+		//chunks always decode with FFmpeg to seek to their first frame
+		float outputScale = m_configuration->FrameResizeEnabled() ? m_configuration->GetFrameResizeProportion() : 1.0f;
+		FFmpegFrameSource video(m_configuration->GetDecoderThreads() > 0 ? m_configuration->GetDecoderThreads() : 1);
+		if (!video.Open(sourceVideo, outputScale) || !video.Seek(chunk.start))
+		{
+			throw std::runtime_error("Video: " + std::string(sourceVideo) + " could not be decoded from frame " + std::to_string(chunk.start));
+		}
+
+		VideoAnalyser chunkAnalyser(m_configuration, m_videoInfo);
+		FpsFrameManager* frameManager = new FpsFrameManager();
+		chunkAnalyser.m_frameManager = frameManager;
+		chunkAnalyser.InitDetectors();
+
+		//values of the detectors that, with the next frames, determine the next frame data
+		auto getState = [&](std::vector<double>& state)
+		{
+			state.clear();
+			frameManager->AppendState(state);
+			chunkAnalyser.m_flashDetection->appendState(state);
+			if (m_configuration->PatternDetectionEnabled())
+			{
+				chunkAnalyser.m_patternDetection->appendState(state);
+			}
+		};
+
+		chunk.frames.clear();
+		chunk.beginState.clear();
+		auto analyseFrames = [&](auto& frame)
+		{
+			unsigned int frameIndex = 0; //relative to the chunk start, the first frame has no previous frame
+			while ((chunk.end < 0 || chunk.start + (int)frameIndex < chunk.end) && chunkAnalyser.ReadFrame(video, frame))
+			{
+				unsigned int videoFrame = chunk.start + frameIndex;
+				FrameData data(videoFrame + 1, 1000.0 * (double)videoFrame / m_videoInfo.fps);
+				chunkAnalyser.AnalyseFrame(frame, frameIndex, data);
+				chunk.frames.push_back(std::move(data));
+				frameIndex++;
+
+				if ((int)videoFrame + 1 == chunk.begin)
+				{
+					getState(chunk.beginState);
+				}
+			}
+			getState(chunk.endState);
+		};
+
+		if (m_configuration->YuvAnalysisEnabled())
+		{
+			YuvFrame frame;
+			analyseFrames(frame);
+		}
+		else
+		{
+			cv::Mat frame;
+			analyseFrames(frame);
+		}
+
+		video.Release();
+	}
+
+	void VideoAnalyser::SetResult(const std::vector<FrameData>& frames, Result& result)
+	{
+		for (const FrameData& data : frames)
+		{
+			AddFlashIncident(data.luminanceFrameResult, result.totalLuminanceIncidents);
+			AddFlashIncident(data.redFrameResult, result.totalRedIncidents);
+			if (data.patternFrameResult == PatternResult::Fail)
+			{
+				result.patternFailFrames += 1;
+			}
+		}
+
+		//same results as FlashDetection::setResult and PatternDetection::setResult
+		if (result.totalLuminanceIncidents.flashFailFrames > 0)
+		{
+			result.OverallResult = AnalysisResult::Fail;
+			result.Results.emplace_back(AnalysisResult::LuminanceFlashFailure);
+			LOG_CORE_CRITICAL("Luminance Flash Failure");
+		}
+
+		if (result.totalLuminanceIncidents.extendedFailFrames > 0)
+		{
+			result.OverallResult = AnalysisResult::Fail;
+			result.Results.emplace_back(AnalysisResult::LuminanceExtendedFlashFailure);
+			LOG_CORE_CRITICAL("Luminance Extended Failure");
+		}
+
+		if (result.totalRedIncidents.flashFailFrames > 0)
+		{
+			result.OverallResult = AnalysisResult::Fail;
+			result.Results.emplace_back(AnalysisResult::RedFlashFailure);
+			LOG_CORE_CRITICAL("Red Flash Failure");
+		}
+
+		if (result.totalRedIncidents.extendedFailFrames > 0)
+		{
+			result.OverallResult = AnalysisResult::Fail;
+			result.Results.emplace_back(AnalysisResult::RedExtendedFlashFailure);
+			LOG_CORE_CRITICAL("Red Extended Failure");
+		}
+
+		if (result.OverallResult != AnalysisResult::Fail && result.totalLuminanceIncidents.passWithWarningFrames > 0)
+		{
+			result.OverallResult = AnalysisResult::PassWithWarning;
+			LOG_CORE_WARNING("Luminance Pass with Warning");
+		}
+
+		if (result.OverallResult != AnalysisResult::Fail && result.totalRedIncidents.passWithWarningFrames > 0)
+		{
+			result.OverallResult = AnalysisResult::PassWithWarning;
+			LOG_CORE_WARNING("Red Pass with Warning");
+		}
+
+		if (result.patternFailFrames > 0)
+		{
+			LOG_CORE_CRITICAL("Pattern Failure");
+			result.OverallResult = AnalysisResult::Fail;
+			result.Results.push_back(AnalysisResult::PatternFailure);
+		}
+	}
+
+	void VideoAnalyser::CheckFrame(const IrisFrame& irisFrame, unsigned int& frameIndex, FrameData& data)
+	{
+		if (m_patternDetection->hasWorkers())
+		{
+			//the pattern workers detect the pattern while the other detectors check the frame
+			m_patternDetection->submitFrame(irisFrame, frameIndex, data);
+		}
+
+		if (m_detectorPool == nullptr)
+		{
+			for (auto detector : m_photosensitivityDetector)
+			{
+				detector->checkFrame(irisFrame, frameIndex, data);
+			}
+			return;
+		}
+
+		//detectors only read the frame and write to different FrameData fields, the first detector
+		//runs in this thread and the rest in the pool, all of them finish before the next frame
+		std::vector<std::future<void>> detectorTasks;
+		detectorTasks.reserve(m_photosensitivityDetector.size() - 1);
+		for (size_t i = 1; i < m_photosensitivityDetector.size(); i++)
+		{
+			PhotosensitivityDetector* detector = m_photosensitivityDetector[i];
+			detectorTasks.emplace_back(m_detectorPool->Enqueue([detector, &irisFrame, &frameIndex, &data]()
+			{
+				detector->checkFrame(irisFrame, frameIndex, data);
+			}));
+		}
+
+		std::exception_ptr detectorError = nullptr;
+		try
+		{
+			m_photosensitivityDetector[0]->checkFrame(irisFrame, frameIndex, data);
+		}
+		catch (...)
+		{
+			detectorError = std::current_exception();
+		}
+
+		for (auto& detectorTask : detectorTasks)
+		{
+			try
+			{
+				detectorTask.get();
+			}
+			catch (...)
+			{
+				if (detectorError == nullptr) { detectorError = std::current_exception(); }
+			}
+		}
+
+		if (detectorError != nullptr)
+		{
+			std::rethrow_exception(detectorError);
+		}
 	}
 
 	void VideoAnalyser::SetOptimalCvThreads(cv::Size size)
@@ -298,11 +1084,7 @@ namespace iris
 			m_videoInfo.frameSize = cv::Size(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT));
 			m_videoInfo.duration = m_videoInfo.frameCount / (float)m_videoInfo.fps;
 
-			LOG_CORE_INFO("Video: {0} opened successful", sourceVideo);
-			LOG_CORE_INFO("Video FPS: {}", m_videoInfo.fps);
-			LOG_CORE_INFO("Total frames: {0}", m_videoInfo.frameCount); 
-			LOG_CORE_INFO("Video resolution: {0}x{1}", m_videoInfo.frameSize.width, m_videoInfo.frameSize.height);
-			LOG_CORE_INFO("Duration: {0}s", m_videoInfo.duration);
+			LogVideoInfo(sourceVideo);
 			return true;
 		}
 
@@ -311,6 +1093,15 @@ namespace iris
 		return false;
 	}
 
+	void VideoAnalyser::LogVideoInfo(const char* sourceVideo)
+	{
+		LOG_CORE_INFO("Video: {0} opened successful", sourceVideo);
+		LOG_CORE_INFO("Video FPS: {}", m_videoInfo.fps);
+		LOG_CORE_INFO("Total frames: {0}", m_videoInfo.frameCount); 
+		LOG_CORE_INFO("Video resolution: {0}x{1}", m_videoInfo.frameSize.width, m_videoInfo.frameSize.height);
+		LOG_CORE_INFO("Duration: {0}s", m_videoInfo.duration);
+	}
+
 	void VideoAnalyser::UpdateProgress(unsigned int& numFrames, const unsigned long& totalFrames, unsigned int& lastPercentage)
 	{
 		unsigned int progress = numFrames / (float)totalFrames * 100.0f;
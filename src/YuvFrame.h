@@ -0,0 +1,30 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// 8 bit 4:2:0 video frame as obtained from the decoder, before any color
+// conversion. Chroma planes have half the luma resolution (rounded up).
+// I420 stores U and V in separate planes, NV12 stores them interleaved in
+// a single CV_8UC2 plane.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <opencv2/core.hpp>
+
+namespace iris
+{
+	struct YuvFrame
+	{
+		enum class Layout { I420, NV12 };
+
+		inline cv::Size size() const { return y.size(); }
+		inline bool empty() const { return y.empty(); }
+
+		cv::Mat y; //luma plane (CV_8UC1)
+		cv::Mat u; //U plane (CV_8UC1) or interleaved UV plane (CV_8UC2) for NV12
+		cv::Mat v; //V plane (CV_8UC1), empty for NV12
+
+		Layout layout = Layout::I420;
+		bool fullRange = false; //JPEG range [0, 255] instead of video range [16, 235]
+		bool bt709 = false; //BT.709 color matrix instead of BT.601
+	};
+}
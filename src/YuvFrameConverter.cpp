@@ -0,0 +1,314 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include "YuvFrameConverter.h"
+#include "YuvFrame.h"
+#include "utils/FrameConverter.h"
+#include <opencv2/core.hpp>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include "FixedPoint.h"
+
+namespace iris
+{
+	namespace
+	{
+		//8 bit RGB values of a pixel
+		inline void ToRgb(int yValue, int uValue, int vValue, const YuvFrameConverter::ColorMatrix& m, uchar& r, uchar& g, uchar& b)
+		{
+			const int u = uValue - 128;
+			const int v = vValue - 128;
+			const int y = (yValue - m.yOffset) * m.yScale + (1 << 15); //rounding
+
+			r = cv::saturate_cast<uchar>((y + m.rv * v) >> 16);
+			g = cv::saturate_cast<uchar>((y - m.gu * u - m.gv * v) >> 16);
+			b = cv::saturate_cast<uchar>((y + m.bu * u) >> 16);
+		}
+
+		//red saturation of a pixel from its linear sRGB values
+		inline float RedSaturation(float r, float g, float b)
+		{
+			//if R / (R + G + B) >= 0.8 => pixel is saturated red, value is (R - G - B) * 320 (negative values set to 0)
+			float red = 0;
+			if (r / (r + g + b) >= 0.8f)
+			{
+				red = (r - g - b) * 320;
+				red = red > 0 ? red : 0;
+			}
+			return red;
+		}
+
+		/// <summary>
+		/// Converts the rows of the frame, red saturation is only calculated if it has the luma resolution
+		/// </summary>
+		template <YuvFrame::Layout layout, bool lumaRed>
+		void ConvertRows(const YuvFrame& frame, const YuvFrameConverter::ColorMatrix& m, const float* sRgb, 
+			cv::Mat& luminance, cv::Mat& redSaturation, const cv::Range& range)
+		{
+			const int cols = frame.y.cols;
+			for (int row = range.start; row < range.end; row++)
+			{
+				const uchar* yRow = frame.y.ptr<uchar>(row);
+				const uchar* uRow = frame.u.ptr<uchar>(row >> 1);
+				const uchar* vRow = layout == YuvFrame::Layout::I420 ? frame.v.ptr<uchar>(row >> 1) : uRow + 1;
+				const int chromaStep = layout == YuvFrame::Layout::I420 ? 1 : 2;
+
+				float* lumRow = luminance.ptr<float>(row);
+				float* redRow = lumaRed ? redSaturation.ptr<float>(row) : nullptr;
+
+				for (int col = 0; col < cols; col++)
+				{
+					const int chroma = (col >> 1) * chromaStep;
+					uchar r8, g8, b8;
+					ToRgb(yRow[col], uRow[chroma], vRow[chroma], m, r8, g8, b8);
+
+					//linear sRGB values
+					float r = sRgb[r8];
+					float g = sRgb[g8];
+					float b = sRgb[b8];
+
+					//Y = 0.0722 * B + 0.7152 * G + 0.2126 * R
+					lumRow[col] = 0.0722f * b + 0.7152f * g + 0.2126f * r;
+
+					if constexpr (lumaRed)
+					{
+						redRow[col] = RedSaturation(r, g, b);
+					}
+				}
+			}
+		}
+
+		template <YuvFrame::Layout layout, bool lumaRed>
+		void ConvertRowsFixed(const YuvFrame& frame, const YuvFrameConverter::ColorMatrix& m, const FixedPoint::FlashTables& tables,
+			cv::Mat& luminance, cv::Mat& redSaturation, long long* luminanceRowSums, long long* redSaturationRowSums, const cv::Range& range)
+		{
+			const int cols = frame.y.cols;
+			for (int row = range.start; row < range.end; row++)
+			{
+				const uchar* yRow = frame.y.ptr<uchar>(row);
+				const uchar* uRow = frame.u.ptr<uchar>(row >> 1);
+				const uchar* vRow = layout == YuvFrame::Layout::I420 ? frame.v.ptr<uchar>(row >> 1) : uRow + 1;
+				const int chromaStep = layout == YuvFrame::Layout::I420 ? 1 : 2;
+
+				int* lumRow = luminance.ptr<int>(row);
+				int* redRow = lumaRed ? redSaturation.ptr<int>(row) : nullptr;
+				long long lumSum = 0, redSum = 0;
+
+				for (int col = 0; col < cols; col++)
+				{
+					const int chroma = (col >> 1) * chromaStep;
+					uchar r8, g8, b8;
+					ToRgb(yRow[col], uRow[chroma], vRow[chroma], m, r8, g8, b8);
+
+					const int lum = tables.Luminance(b8, g8, r8);
+					lumRow[col] = lum;
+					lumSum += lum;
+
+					if constexpr (lumaRed)
+					{
+						const int red = FixedPoint::RedSaturation(tables.sRgb[r8], tables.sRgb[g8], tables.sRgb[b8]);
+						redRow[col] = red;
+						redSum += red;
+					}
+				}
+
+				luminanceRowSums[row] = lumSum;
+				if constexpr (lumaRed)
+				{
+					redSaturationRowSums[row] = redSum;
+				}
+			}
+		}
+
+		/// <summary>
+		/// Calculates the red saturation of the rows of the chroma grid, each value is obtained from the chroma
+		/// of a 2x2 block and the mean of its luma values. The row sums are only calculated if not null
+		/// </summary>
+		template <YuvFrame::Layout layout, typename Value, typename RedFn>
+		void ConvertChromaRows(const YuvFrame& frame, const YuvFrameConverter::ColorMatrix& m, cv::Mat& redSaturation,
+			long long* redSaturationRowSums, const cv::Range& range, RedFn redFn)
+		{
+			const int chromaStep = layout == YuvFrame::Layout::I420 ? 1 : 2;
+			const int lastRow = frame.y.rows - 1, lastCol = frame.y.cols - 1;
+			for (int row = range.start; row < range.end; row++)
+			{
+				//odd frame sizes repeat the last luma row and column
+				const uchar* yRow0 = frame.y.ptr<uchar>(2 * row);
+				const uchar* yRow1 = frame.y.ptr<uchar>(std::min(2 * row + 1, lastRow));
+				const uchar* uRow = frame.u.ptr<uchar>(row);
+				const uchar* vRow = layout == YuvFrame::Layout::I420 ? frame.v.ptr<uchar>(row) : uRow + 1;
+
+				Value* redRow = redSaturation.ptr<Value>(row);
+				long long redSum = 0;
+
+				for (int col = 0; col < redSaturation.cols; col++)
+				{
+					const int x0 = 2 * col, x1 = std::min(2 * col + 1, lastCol);
+					const int yMean = (yRow0[x0] + yRow0[x1] + yRow1[x0] + yRow1[x1] + 2) >> 2;
+					uchar r8, g8, b8;
+					ToRgb(yMean, uRow[col * chromaStep], vRow[col * chromaStep], m, r8, g8, b8);
+
+					redRow[col] = redFn(r8, g8, b8);
+					if constexpr (std::is_integral_v<Value>)
+					{
+						redSum += redRow[col];
+					}
+				}
+
+				if (redSaturationRowSums != nullptr)
+				{
+					redSaturationRowSums[row] = redSum;
+				}
+			}
+		}
+	}
+
+	YuvFrameConverter::YuvFrameConverter(EA::EACC::Utils::FrameConverterParams* params) : m_sRgbValues(params->values), m_fixedTables(params->values)
+	{
+	}
+
+	YuvFrameConverter::ColorMatrix YuvFrameConverter::GetColorMatrix(bool fullRange, bool bt709)
+	{
+		//luma coefficients of the red and blue components
+		const double kr = bt709 ? 0.2126 : 0.299;
+		const double kb = bt709 ? 0.0722 : 0.114;
+		const double kg = 1.0 - kr - kb;
+
+		//video range scales [16, 235] luma and [16, 240] chroma to [0, 255]
+		const double yScale = fullRange ? 1.0 : 255.0 / 219.0;
+		const double cScale = fullRange ? 1.0 : 255.0 / 224.0;
+		const double q16 = 65536.0;
+
+		ColorMatrix matrix;
+		matrix.yOffset = fullRange ? 0 : 16;
+		matrix.yScale = std::lround(yScale * q16);
+		matrix.rv = std::lround(2.0 * (1.0 - kr) * cScale * q16);
+		matrix.gu = std::lround(2.0 * (1.0 - kb) * kb / kg * cScale * q16);
+		matrix.gv = std::lround(2.0 * (1.0 - kr) * kr / kg * cScale * q16);
+		matrix.bu = std::lround(2.0 * (1.0 - kb) * cScale * q16);
+		return matrix;
+	}
+
+	cv::Size YuvFrameConverter::GetRedSaturationSize(const YuvFrame& frame) const
+	{
+		return m_chromaRedSaturation ? cv::Size((frame.y.cols + 1) / 2, (frame.y.rows + 1) / 2) : frame.size();
+	}
+
+	void YuvFrameConverter::Convert(const YuvFrame& frame, cv::Mat& luminance, cv::Mat& redSaturation)
+	{
+		luminance.create(frame.size(), CV_32FC1);
+		redSaturation.create(GetRedSaturationSize(frame), CV_32FC1);
+
+		const ColorMatrix matrix = GetColorMatrix(frame.fullRange, frame.bt709);
+		const float* sRgb = m_sRgbValues.data();
+		const bool i420 = frame.layout == YuvFrame::Layout::I420;
+
+		if (m_chromaRedSaturation)
+		{
+			auto red = [sRgb](uchar r8, uchar g8, uchar b8) { return RedSaturation(sRgb[r8], sRgb[g8], sRgb[b8]); };
+			cv::parallel_for_(cv::Range(0, frame.y.rows), [&](const cv::Range& range)
+			{
+				if (i420)
+				{
+					ConvertRows<YuvFrame::Layout::I420, false>(frame, matrix, sRgb, luminance, redSaturation, range);
+				}
+				else
+				{
+					ConvertRows<YuvFrame::Layout::NV12, false>(frame, matrix, sRgb, luminance, redSaturation, range);
+				}
+			});
+			cv::parallel_for_(cv::Range(0, redSaturation.rows), [&](const cv::Range& range)
+			{
+				if (i420)
+				{
+					ConvertChromaRows<YuvFrame::Layout::I420, float>(frame, matrix, redSaturation, nullptr, range, red);
+				}
+				else
+				{
+					ConvertChromaRows<YuvFrame::Layout::NV12, float>(frame, matrix, redSaturation, nullptr, range, red);
+				}
+			});
+		}
+		else
+		{
+			cv::parallel_for_(cv::Range(0, frame.y.rows), [&](const cv::Range& range)
+			{
+				if (i420)
+				{
+					ConvertRows<YuvFrame::Layout::I420, true>(frame, matrix, sRgb, luminance, redSaturation, range);
+				}
+				else
+				{
+					ConvertRows<YuvFrame::Layout::NV12, true>(frame, matrix, sRgb, luminance, redSaturation, range);
+				}
+			});
+		}
+	}
+
+	void YuvFrameConverter::ConvertFixed(const YuvFrame& frame, cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean)
+	{
+		luminance.create(frame.size(), CV_32SC1);
+		redSaturation.create(GetRedSaturationSize(frame), CV_32SC1);
+
+		m_luminanceRowSums.resize(frame.y.rows);
+		m_redSaturationRowSums.resize(redSaturation.rows);
+
+		const ColorMatrix matrix = GetColorMatrix(frame.fullRange, frame.bt709);
+		const FixedPoint::FlashTables& tables = m_fixedTables;
+		const bool i420 = frame.layout == YuvFrame::Layout::I420;
+
+		if (m_chromaRedSaturation)
+		{
+			auto red = [&tables](uchar r8, uchar g8, uchar b8) { return FixedPoint::RedSaturation(tables.sRgb[r8], tables.sRgb[g8], tables.sRgb[b8]); };
+			cv::parallel_for_(cv::Range(0, frame.y.rows), [&](const cv::Range& range)
+			{
+				if (i420)
+				{
+					ConvertRowsFixed<YuvFrame::Layout::I420, false>(frame, matrix, tables, luminance, redSaturation, m_luminanceRowSums.data(), nullptr, range);
+				}
+				else
+				{
+					ConvertRowsFixed<YuvFrame::Layout::NV12, false>(frame, matrix, tables, luminance, redSaturation, m_luminanceRowSums.data(), nullptr, range);
+				}
+			});
+			cv::parallel_for_(cv::Range(0, redSaturation.rows), [&](const cv::Range& range)
+			{
+				if (i420)
+				{
+					ConvertChromaRows<YuvFrame::Layout::I420, int>(frame, matrix, redSaturation, m_redSaturationRowSums.data(), range, red);
+				}
+				else
+				{
+					ConvertChromaRows<YuvFrame::Layout::NV12, int>(frame, matrix, redSaturation, m_redSaturationRowSums.data(), range, red);
+				}
+			});
+		}
+		else
+		{
+			cv::parallel_for_(cv::Range(0, frame.y.rows), [&](const cv::Range& range)
+			{
+				if (i420)
+				{
+					ConvertRowsFixed<YuvFrame::Layout::I420, true>(frame, matrix, tables, luminance, redSaturation, m_luminanceRowSums.data(), m_redSaturationRowSums.data(), range);
+				}
+				else
+				{
+					ConvertRowsFixed<YuvFrame::Layout::NV12, true>(frame, matrix, tables, luminance, redSaturation, m_luminanceRowSums.data(), m_redSaturationRowSums.data(), range);
+				}
+			});
+		}
+
+		long long lumTotal = 0, redTotal = 0;
+		for (int row = 0; row < luminance.rows; row++)
+		{
+			lumTotal += m_luminanceRowSums[row];
+		}
+		for (int row = 0; row < redSaturation.rows; row++)
+		{
+			redTotal += m_redSaturationRowSums[row];
+		}
+
+		luminanceMean = FixedPoint::ToMean(lumTotal, luminance.total());
+		redSaturationMean = FixedPoint::ToMean(redTotal, redSaturation.total());
+	}
+}
@@ -0,0 +1,84 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+/////////////////////////////////////////////////////////////////////////////
+// Converts 4:2:0 YUV frames straight into the flash detection values.
+// Each pixel is converted to 8 bit RGB with a fixed point color matrix,
+// linearized with the sRGB look up table and reduced to its relative
+// luminance and red saturation in a single pass, so neither the BGR frame
+// nor the CV_32FC3 sRGB frame are ever created. Red saturation can also
+// be calculated at the resolution of the chroma planes, each value from
+// the chroma of a 2x2 block and the mean of its luma values.
+/////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <vector>
+#include <opencv2/core/types.hpp>
+#include "FixedPoint.h"
+
+namespace cv
+{
+	class Mat;
+}
+
+namespace EA::EACC::Utils
+{
+	struct FrameConverterParams;
+}
+
+namespace iris
+{
+	struct YuvFrame;
+
+	class YuvFrameConverter
+	{
+	public:
+		/// <param name="params">sRGB look up table values, same as the ones used by FrameConverter</param>
+		YuvFrameConverter(EA::EACC::Utils::FrameConverterParams* params);
+
+		/// <summary>
+		/// Calculates the relative luminance and red saturation values of a YUV frame
+		/// </summary>
+		/// <param name="frame">decoded YUV frame</param>
+		/// <param name="luminance">output relative luminance values (CV_32FC1)</param>
+		/// <param name="redSaturation">output red saturation values (CV_32FC1)</param>
+		void Convert(const YuvFrame& frame, cv::Mat& luminance, cv::Mat& redSaturation);
+
+		/// <summary>
+		/// Calculates the fixed point relative luminance and red saturation values of a YUV frame and their exact frame means
+		/// </summary>
+		/// <param name="frame">decoded YUV frame</param>
+		/// <param name="luminance">output Q16 relative luminance values (CV_32SC1)</param>
+		/// <param name="redSaturation">output Q16 red saturation values (CV_32SC1)</param>
+		/// <param name="luminanceMean">output mean of the relative luminance values</param>
+		/// <param name="redSaturationMean">output mean of the red saturation values</param>
+		void ConvertFixed(const YuvFrame& frame, cv::Mat& luminance, cv::Mat& redSaturation, float& luminanceMean, float& redSaturationMean);
+
+		/// <summary>
+		/// Calculates red saturation at the resolution of the chroma planes instead of the luma resolution
+		/// </summary>
+		inline void SetChromaRedSaturation(bool enabled) { m_chromaRedSaturation = enabled; }
+
+		/// <summary>
+		/// Size of the red saturation values of the frame, the chroma plane size if red saturation is calculated at chroma resolution
+		/// </summary>
+		cv::Size GetRedSaturationSize(const YuvFrame& frame) const;
+
+		//fixed point (Q16) YUV to RGB coefficients
+		struct ColorMatrix
+		{
+			int yOffset;
+			int yScale;
+			int rv, gu, gv, bu;
+		};
+
+		static ColorMatrix GetColorMatrix(bool fullRange, bool bt709);
+
+	private:
+		std::vector<float> m_sRgbValues; //8 bit to linear sRGB look up table
+		bool m_chromaRedSaturation = false;
+
+		FixedPoint::FlashTables m_fixedTables;
+		std::vector<long long> m_luminanceRowSums;
+		std::vector<long long> m_redSaturationRowSums;
+	};
+}
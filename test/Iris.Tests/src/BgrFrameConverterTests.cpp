@@ -0,0 +1,159 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include "IrisLibTest.h"
+#include "utils/FrameConverter.h"
+#include "BgrFrameConverter.h"
+#include "FrameChangeTracker.h"
+#include "RelativeLuminance.h"
+#include "RedSaturation.h"
+#include "IrisFrame.h"
+#include "FpsFrameManager.h"
+
+namespace iris::Tests
+{
+	class BgrFrameConverterTests : public IrisLibTest {
+	protected:
+		EA::EACC::Utils::FrameConverter* frameRgbConverter = nullptr;
+		BgrFrameConverter* bgrConverter = nullptr;
+		IFrameManager* frameManager = nullptr;
+		cv::Size size{ 64, 48 };
+
+		void SetUp() override
+		{
+			IrisLibTest::SetUp();
+			frameRgbConverter = new EA::EACC::Utils::FrameConverter(configuration.GetFrameSrgbConverterParams());
+			bgrConverter = new BgrFrameConverter(configuration.GetFrameSrgbConverterParams());
+			frameManager = new FpsFrameManager();
+		}
+
+		~BgrFrameConverterTests() override
+		{
+			delete frameRgbConverter;
+			delete bgrConverter;
+			delete frameManager;
+		}
+
+		//checks the fused conversion against the BGR -> sRGB -> luminance/red saturation flow
+		void CompareWithSrgb(const cv::Mat& bgr)
+		{
+			RelativeLuminance luminance(30, bgr.size(), configuration.GetLuminanceFlashParams(), frameManager);
+			RedSaturation redSaturation(30, bgr.size(), configuration.GetRedSaturationFlashParams(), frameManager);
+			cv::Mat bgrSrgb;
+			frameRgbConverter->Convert(bgr, bgrSrgb);
+			IrisFrame irisFrame(&bgr, &bgrSrgb, FrameData());
+			luminance.SetCurrentFrame(irisFrame);
+			redSaturation.SetCurrentFrame(irisFrame);
+
+			cv::Mat fusedLuminance, fusedRed;
+			float luminanceMean = -1, redMean = -1;
+			bgrConverter->Convert(bgr, fusedLuminance, fusedRed, luminanceMean, redMean);
+
+			ASSERT_EQ(bgr.size(), fusedLuminance.size());
+			ASSERT_EQ(CV_32FC1, fusedLuminance.type());
+			ASSERT_EQ(CV_32FC1, fusedRed.type());
+
+			//same operations on every pixel, only the mean accumulation order differs
+			EXPECT_EQ(0, cv::norm(luminance.getCurrentFrame(), fusedLuminance, cv::NORM_INF));
+			EXPECT_EQ(0, cv::norm(redSaturation.getCurrentFrame(), fusedRed, cv::NORM_INF));
+			EXPECT_NEAR(luminance.GetFrameMean(), luminanceMean, 1e-5);
+			EXPECT_NEAR(redSaturation.GetFrameMean(), redMean, 1e-3);
+		}
+	};
+
+	TEST_F(BgrFrameConverterTests, Solid_Frames)
+	{
+		for (const cv::Scalar& color : { white, black, gray, red, blue })
+		{
+			CompareWithSrgb(cv::Mat(size, CV_8UC3, color));
+		}
+	}
+
+	TEST_F(BgrFrameConverterTests, Random_Frame)
+	{
+		cv::Mat bgr(size, CV_8UC3);
+		cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(256));
+
+		//half of the frame saturated red
+		cv::Mat redHalf = bgr(cv::Rect(0, 0, size.width / 2, size.height));
+		cv::randu(redHalf, cv::Scalar(0, 0, 200), cv::Scalar(40, 40, 256));
+
+		CompareWithSrgb(bgr);
+	}
+
+	TEST_F(BgrFrameConverterTests, Means_Are_Set_On_Flash)
+	{
+		cv::Mat bgr(size, CV_8UC3, red);
+		cv::Mat luminanceFrame, redFrame;
+
+		IrisFrame irisFrame(&bgr, FrameData());
+		bgrConverter->Convert(bgr, luminanceFrame, redFrame, irisFrame.luminanceMean, irisFrame.redSaturationMean);
+		irisFrame.luminanceFrame = &luminanceFrame;
+		irisFrame.redSaturationFrame = &redFrame;
+
+		RelativeLuminance luminance(30, size, configuration.GetLuminanceFlashParams(), frameManager);
+		RedSaturation redSaturation(30, size, configuration.GetRedSaturationFlashParams(), frameManager);
+		luminance.SetCurrentFrame(irisFrame);
+		redSaturation.SetCurrentFrame(irisFrame);
+
+		EXPECT_FLOAT_EQ(irisFrame.luminanceMean, luminance.GetFrameMean());
+		EXPECT_FLOAT_EQ(irisFrame.redSaturationMean, redSaturation.GetFrameMean());
+		EXPECT_GT(redSaturation.GetFrameMean(), 0);
+	}
+
+	TEST_F(BgrFrameConverterTests, Changed_Tiles_Match_Full_Conversion)
+	{
+		cv::Mat frame(cv::Size(150, 100), CV_8UC3), nextFrame;
+		cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+		nextFrame = frame.clone();
+		cv::Mat changedArea = nextFrame(cv::Rect(50, 50, 30, 30)); //crosses 4 tiles
+		cv::randu(changedArea, cv::Scalar::all(0), cv::Scalar::all(256));
+
+		FrameChangeTracker tracker;
+		FrameTiles tiles;
+		EXPECT_FALSE(tracker.IsRepeated(frame, tiles));
+
+		cv::Mat luminance, red, nextLuminance, nextRed, fullLuminance, fullRed;
+		float luminanceMean, redMean, nextLuminanceMean, nextRedMean, fullLuminanceMean, fullRedMean;
+		bgrConverter->Convert(frame, tiles, nullptr, nullptr, luminance, red, luminanceMean, redMean);
+
+		EXPECT_FALSE(tracker.IsRepeated(nextFrame, tiles));
+		EXPECT_EQ(4, cv::countNonZero(cv::Mat(tiles.changed)));
+		bgrConverter->Convert(nextFrame, tiles, &luminance, &red, nextLuminance, nextRed, nextLuminanceMean, nextRedMean);
+
+		BgrFrameConverter fullConverter(configuration.GetFrameSrgbConverterParams());
+		fullConverter.Convert(nextFrame, fullLuminance, fullRed, fullLuminanceMean, fullRedMean);
+
+		EXPECT_EQ(0, cv::norm(fullLuminance, nextLuminance, cv::NORM_INF));
+		EXPECT_EQ(0, cv::norm(fullRed, nextRed, cv::NORM_INF));
+		EXPECT_EQ(fullLuminanceMean, nextLuminanceMean);
+		EXPECT_EQ(fullRedMean, nextRedMean);
+
+		EXPECT_TRUE(tracker.IsRepeated(nextFrame.clone(), tiles));
+	}
+
+	TEST_F(BgrFrameConverterTests, Excluded_Pixels_Are_Not_Converted)
+	{
+		cv::Mat frame(cv::Size(150, 100), CV_8UC3);
+		cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+
+		cv::Mat luminance, red, maskedLuminance, maskedRed;
+		float luminanceMean, redMean, maskedLuminanceMean, maskedRedMean;
+
+		//same as converting a frame whose excluded pixels are black
+		const cv::Rect hud(10, 70, 60, 20);
+		cv::Mat blackHud = frame.clone(), hudArea = blackHud(hud);
+		hudArea.setTo(cv::Scalar::all(0));
+		bgrConverter->Convert(blackHud, luminance, red, luminanceMean, redMean);
+
+		ExclusionMask mask(frame.size(), { hud });
+		BgrFrameConverter maskedConverter(configuration.GetFrameSrgbConverterParams());
+		maskedConverter.SetExclusionMask(&mask);
+		maskedConverter.Convert(frame, maskedLuminance, maskedRed, maskedLuminanceMean, maskedRedMean);
+
+		EXPECT_EQ(0, cv::norm(luminance, maskedLuminance, cv::NORM_INF));
+		EXPECT_EQ(0, cv::norm(red, maskedRed, cv::NORM_INF));
+		EXPECT_EQ(luminanceMean, maskedLuminanceMean);
+		EXPECT_EQ(redMean, maskedRedMean);
+	}
+}
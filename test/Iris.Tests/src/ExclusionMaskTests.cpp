@@ -0,0 +1,30 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include "ExclusionMask.h"
+
+namespace iris::Tests
+{
+	TEST(ExclusionMaskTests, Row_Spans)
+	{
+		//overlapping areas and an area partly outside the frame
+		ExclusionMask mask(cv::Size(20, 10), { cv::Rect(2, 0, 4, 3), cv::Rect(4, 2, 4, 2), cv::Rect(16, 8, 10, 10) });
+
+		ASSERT_EQ(10, (int)mask.spans.size());
+		EXPECT_EQ((std::vector<cv::Range>{ cv::Range(0, 2), cv::Range(6, 20) }), mask.spans[0]);
+		EXPECT_EQ((std::vector<cv::Range>{ cv::Range(0, 2), cv::Range(8, 20) }), mask.spans[2]);
+		EXPECT_EQ((std::vector<cv::Range>{ cv::Range(0, 4), cv::Range(8, 20) }), mask.spans[3]);
+		EXPECT_EQ((std::vector<cv::Range>{ cv::Range(0, 20) }), mask.spans[5]);
+		EXPECT_EQ((std::vector<cv::Range>{ cv::Range(0, 16) }), mask.spans[9]);
+		EXPECT_EQ(4 * 3 + 4 * 2 - 2 + 4 * 2, mask.excludedPixels);
+
+		//spans clipped to the columns
+		std::vector<cv::Range> spans;
+		mask.ForEachSpan(0, 1, 10, [&](int begin, int end) { spans.emplace_back(begin, end); });
+		EXPECT_EQ((std::vector<cv::Range>{ cv::Range(1, 2), cv::Range(6, 10) }), spans);
+
+		spans.clear();
+		mask.ForEachSpan(9, 16, 20, [&](int begin, int end) { spans.emplace_back(begin, end); });
+		EXPECT_TRUE(spans.empty());
+	}
+}
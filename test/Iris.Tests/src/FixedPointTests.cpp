@@ -0,0 +1,117 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include "IrisLibTest.h"
+#include "utils/FrameConverter.h"
+#include "BgrFrameConverter.h"
+#include "YuvFrameConverter.h"
+#include "YuvFrame.h"
+#include "FixedPoint.h"
+#include <opencv2/imgproc.hpp>
+
+namespace iris::Tests
+{
+	class FixedPointTests : public IrisLibTest {
+	protected:
+		BgrFrameConverter* bgrConverter = nullptr;
+		cv::Size size{ 64, 48 };
+
+		void SetUp() override
+		{
+			IrisLibTest::SetUp();
+			bgrConverter = new BgrFrameConverter(configuration.GetFrameSrgbConverterParams());
+		}
+
+		~FixedPointTests() override
+		{
+			delete bgrConverter;
+		}
+
+		cv::Mat RandomFrame()
+		{
+			cv::Mat bgr(size, CV_8UC3);
+			cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(256));
+
+			//half of the frame saturated red
+			cv::Mat redHalf = bgr(cv::Rect(0, 0, size.width / 2, size.height));
+			cv::randu(redHalf, cv::Scalar(0, 0, 200), cv::Scalar(40, 40, 256));
+			return bgr;
+		}
+	};
+
+	TEST_F(FixedPointTests, Red_Saturation_Threshold)
+	{
+		const int one = FixedPoint::One;
+		EXPECT_EQ(320 * one, FixedPoint::RedSaturation(one, 0, 0));
+		EXPECT_EQ(0, FixedPoint::RedSaturation(0, 0, 0));
+
+		//R / (R + G + B) = 0.8 is saturated red, below is not
+		EXPECT_EQ(320 * (8000 - 2000), FixedPoint::RedSaturation(8000, 1000, 1000));
+		EXPECT_EQ(0, FixedPoint::RedSaturation(7999, 1000, 1000));
+	}
+
+	TEST_F(FixedPointTests, Matches_Float_Values)
+	{
+		cv::Mat bgr = RandomFrame();
+
+		cv::Mat luminance, red, fixedLuminance, fixedRed;
+		float luminanceMean, redMean, fixedLuminanceMean, fixedRedMean;
+		bgrConverter->Convert(bgr, luminance, red, luminanceMean, redMean);
+		bgrConverter->ConvertFixed(bgr, fixedLuminance, fixedRed, fixedLuminanceMean, fixedRedMean);
+
+		ASSERT_EQ(CV_32SC1, fixedLuminance.type());
+		ASSERT_EQ(CV_32SC1, fixedRed.type());
+
+		cv::Mat fixedLuminanceFloat, fixedRedFloat;
+		fixedLuminance.convertTo(fixedLuminanceFloat, CV_32F, 1.0 / FixedPoint::One);
+		fixedRed.convertTo(fixedRedFloat, CV_32F, 1.0 / FixedPoint::One);
+
+		//rounding of the Q16 tables is the only difference
+		EXPECT_LE(cv::norm(luminance, fixedLuminanceFloat, cv::NORM_INF), 2.0 / FixedPoint::One);
+		EXPECT_LE(cv::norm(red, fixedRedFloat, cv::NORM_INF), 320 * 3.0 / FixedPoint::One);
+		EXPECT_NEAR(luminanceMean, fixedLuminanceMean, 1e-4);
+		EXPECT_NEAR(redMean, fixedRedMean, 1e-2);
+	}
+
+	TEST_F(FixedPointTests, Means_Do_Not_Depend_On_Threads)
+	{
+		cv::Mat bgr = RandomFrame();
+		cv::Mat luminance, red;
+		float luminanceMean, redMean, singleThreadLuminanceMean, singleThreadRedMean;
+
+		bgrConverter->ConvertFixed(bgr, luminance, red, luminanceMean, redMean);
+
+		int threads = cv::getNumThreads();
+		cv::setNumThreads(1);
+		bgrConverter->ConvertFixed(bgr, luminance, red, singleThreadLuminanceMean, singleThreadRedMean);
+		cv::setNumThreads(threads);
+
+		EXPECT_EQ(luminanceMean, singleThreadLuminanceMean);
+		EXPECT_EQ(redMean, singleThreadRedMean);
+		EXPECT_FLOAT_EQ(FixedPoint::ToMean(cv::sum(luminance)[0], luminance.total()), luminanceMean);
+	}
+
+	TEST_F(FixedPointTests, Yuv_Matches_Float_Values)
+	{
+		cv::Mat bgr = RandomFrame();
+		cv::Mat i420;
+		cv::cvtColor(bgr, i420, cv::COLOR_BGR2YUV_I420);
+
+		YuvFrame frame;
+		frame.y = i420.rowRange(0, bgr.rows).clone();
+		frame.u = i420.rowRange(bgr.rows, bgr.rows + bgr.rows / 4).clone().reshape(1, bgr.rows / 2);
+		frame.v = i420.rowRange(bgr.rows + bgr.rows / 4, bgr.rows * 3 / 2).clone().reshape(1, bgr.rows / 2);
+
+		YuvFrameConverter yuvConverter(configuration.GetFrameSrgbConverterParams());
+		cv::Mat luminance, red, fixedLuminance, fixedRed;
+		float fixedLuminanceMean, fixedRedMean;
+		yuvConverter.Convert(frame, luminance, red);
+		yuvConverter.ConvertFixed(frame, fixedLuminance, fixedRed, fixedLuminanceMean, fixedRedMean);
+
+		cv::Mat fixedLuminanceFloat;
+		fixedLuminance.convertTo(fixedLuminanceFloat, CV_32F, 1.0 / FixedPoint::One);
+		EXPECT_LE(cv::norm(luminance, fixedLuminanceFloat, cv::NORM_INF), 2.0 / FixedPoint::One);
+		EXPECT_NEAR(cv::mean(luminance)[0], fixedLuminanceMean, 1e-4);
+		EXPECT_NEAR(cv::mean(red)[0], fixedRedMean, 1e-2);
+	}
+}
@@ -43,9 +43,15 @@ TEST_F(FlashDetectionTests, RELATIVE_LUMINANCE)
     EA::EACC::Utils::FrameConverter sRgbConverter(configuration.GetFrameSrgbConverterParams());
 
     FrameData data;
-    IrisFrame irisBlackFrame(&blackFrame, sRgbConverter.Convert(blackFrame), FrameData());
-    IrisFrame irisWhiteFrame(&whiteFrame, sRgbConverter.Convert(whiteFrame), FrameData());
-    IrisFrame irisRedFrame(&redFrame, sRgbConverter.Convert(redFrame), FrameData());
+    cv::Mat blackFrameSrgb;
+    sRgbConverter.Convert(blackFrame, blackFrameSrgb);
+    IrisFrame irisBlackFrame(&blackFrame, &blackFrameSrgb, FrameData());
+    cv::Mat whiteFrameSrgb;
+    sRgbConverter.Convert(whiteFrame, whiteFrameSrgb);
+    IrisFrame irisWhiteFrame(&whiteFrame, &whiteFrameSrgb, FrameData());
+    cv::Mat redFrameSrgb;
+    sRgbConverter.Convert(redFrame, redFrameSrgb);
+    IrisFrame irisRedFrame(&redFrame, &redFrameSrgb, FrameData());
 
     //add transitions
     flashDetection.setLuminance(irisBlackFrame);
@@ -96,10 +102,6 @@ TEST_F(FlashDetectionTests, RELATIVE_LUMINANCE)
     EXPECT_EQ(expectedData.redFrameResult, data.redFrameResult);
 
     EXPECT_FALSE(flashDetection.isFail());
-
-    irisBlackFrame.Release();
-    irisRedFrame.Release();
-    irisWhiteFrame.Release();
 }
 
 TEST_F(FlashDetectionTests, RealTime_RELATIVE_LUMINANCE)
@@ -118,9 +120,15 @@ TEST_F(FlashDetectionTests, RealTime_RELATIVE_LUMINANCE)
     EA::EACC::Utils::FrameConverter sRgbConverter(configuration.GetFrameSrgbConverterParams());
 
     FrameData data;
-    IrisFrame irisBlackFrame(&blackFrame, sRgbConverter.Convert(blackFrame), FrameData());
-    IrisFrame irisWhiteFrame(&whiteFrame, sRgbConverter.Convert(whiteFrame), FrameData());
-    IrisFrame irisRedFrame(&redFrame, sRgbConverter.Convert(redFrame), FrameData());
+    cv::Mat blackFrameSrgb;
+    sRgbConverter.Convert(blackFrame, blackFrameSrgb);
+    IrisFrame irisBlackFrame(&blackFrame, &blackFrameSrgb, FrameData());
+    cv::Mat whiteFrameSrgb;
+    sRgbConverter.Convert(whiteFrame, whiteFrameSrgb);
+    IrisFrame irisWhiteFrame(&whiteFrame, &whiteFrameSrgb, FrameData());
+    cv::Mat redFrameSrgb;
+    sRgbConverter.Convert(redFrame, redFrameSrgb);
+    IrisFrame irisRedFrame(&redFrame, &redFrameSrgb, FrameData());
 
     //add transitions
     frameManager.AddFrame(data);
@@ -176,10 +184,6 @@ TEST_F(FlashDetectionTests, RealTime_RELATIVE_LUMINANCE)
     EXPECT_EQ(expectedData.redFrameResult, data.redFrameResult);
 
     EXPECT_FALSE(flashDetection.isFail());
-
-    irisBlackFrame.Release();
-    irisRedFrame.Release();
-    irisWhiteFrame.Release();
 }
 
 }
\ No newline at end of file
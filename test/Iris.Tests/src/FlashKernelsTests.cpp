@@ -0,0 +1,117 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "FlashKernels.h"
+
+namespace iris::Tests
+{
+	class FlashKernelsTests : public ::testing::Test {
+	protected:
+		//row lengths covering full SIMD blocks and every tail size
+		std::vector<int> lengths = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 47, 64, 1921 };
+
+		//interleaved sRGB pixels with black, saturated red and random pixels
+		std::vector<float> RandomPixels(int pixels)
+		{
+			std::mt19937 generator(pixels);
+			std::uniform_real_distribution<float> value(0, 1);
+			std::vector<float> sRgb(pixels * 3);
+			for (int i = 0; i < pixels; i++)
+			{
+				float* pixel = &sRgb[i * 3];
+				switch (i % 4)
+				{
+				case 0: pixel[0] = pixel[1] = pixel[2] = 0; break;
+				case 1: pixel[0] = value(generator) * 0.1f; pixel[1] = value(generator) * 0.1f; pixel[2] = value(generator); break;
+				default: pixel[0] = value(generator); pixel[1] = value(generator); pixel[2] = value(generator); break;
+				}
+			}
+			return sRgb;
+		}
+
+		static bool BitIdentical(const std::vector<float>& a, const std::vector<float>& b)
+		{
+			return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+		}
+	};
+
+	TEST_F(FlashKernelsTests, Scalar_Matches_Flash_Values)
+	{
+		const FlashKernels& scalar = FlashKernelsIsa::Scalar();
+		const float sRgb[] = { 0.1f, 0.2f, 1.0f,   0.01f, 0.02f, 0.9f,   0, 0, 0 };
+		float luminance[3], red[3];
+		scalar.relativeLuminance(sRgb, luminance, 3);
+		scalar.redSaturation(sRgb, red, 3);
+
+		EXPECT_FLOAT_EQ(0.0722f * 0.1f + 0.7152f * 0.2f + 0.2126f * 1.0f, luminance[0]);
+		EXPECT_FLOAT_EQ(0, red[0]); //R / (R + G + B) < 0.8
+		EXPECT_FLOAT_EQ((0.9f - 0.02f - 0.01f) * 320, red[1]);
+		EXPECT_EQ(0, luminance[2]);
+		EXPECT_EQ(0, red[2]);
+	}
+
+	TEST_F(FlashKernelsTests, Supported_Kernels_Are_Bit_Identical)
+	{
+		const FlashKernels& scalar = FlashKernelsIsa::Scalar();
+		EXPECT_NE(nullptr, &FlashKernels::Get());
+
+		for (const FlashKernels* kernels : FlashKernels::GetSupported())
+		{
+			for (int pixels : lengths)
+			{
+				std::vector<float> sRgb = RandomPixels(pixels);
+				std::vector<float> expected(pixels), result(pixels, -1);
+
+				scalar.relativeLuminance(sRgb.data(), expected.data(), pixels);
+				kernels->relativeLuminance(sRgb.data(), result.data(), pixels);
+				EXPECT_TRUE(BitIdentical(expected, result)) << kernels->name << " luminance, pixels: " << pixels;
+
+				std::fill(result.begin(), result.end(), -1.0f);
+				scalar.redSaturation(sRgb.data(), expected.data(), pixels);
+				kernels->redSaturation(sRgb.data(), result.data(), pixels);
+				EXPECT_TRUE(BitIdentical(expected, result)) << kernels->name << " red saturation, pixels: " << pixels;
+
+				std::vector<float> last(sRgb.begin(), sRgb.begin() + pixels), current(sRgb.end() - pixels, sRgb.end());
+				std::fill(result.begin(), result.end(), -1.0f);
+				scalar.subtract(current.data(), last.data(), expected.data(), pixels);
+				kernels->subtract(current.data(), last.data(), result.data(), pixels);
+				EXPECT_TRUE(BitIdentical(expected, result)) << kernels->name << " difference, pixels: " << pixels;
+
+				EXPECT_EQ(scalar.countNonZero(expected.data(), pixels), kernels->countNonZero(expected.data(), pixels)) << kernels->name << " pixels: " << pixels;
+
+				//half of the values unchanged
+				std::copy(last.begin(), last.begin() + pixels / 2, current.begin());
+				scalar.subtract(current.data(), last.data(), expected.data(), pixels);
+				EXPECT_EQ(scalar.countNonZero(expected.data(), pixels), kernels->countChanged(current.data(), last.data(), pixels)) << kernels->name << " pixels: " << pixels;
+
+				std::vector<int> lastFixed(pixels), currentFixed(pixels);
+				for (int i = 0; i < pixels; i++)
+				{
+					lastFixed[i] = (int)(last[i] * 65536);
+					currentFixed[i] = (int)(current[i] * 65536);
+				}
+				EXPECT_EQ(scalar.countChangedFixed(currentFixed.data(), lastFixed.data(), pixels),
+					kernels->countChangedFixed(currentFixed.data(), lastFixed.data(), pixels)) << kernels->name << " pixels: " << pixels;
+			}
+		}
+	}
+
+	TEST_F(FlashKernelsTests, Count_Non_Zero)
+	{
+		std::vector<float> values(37, 0.0f);
+		values[0] = 1;
+		values[8] = -0.0f; //equal to zero
+		values[16] = std::numeric_limits<float>::quiet_NaN();
+		values[20] = -3;
+		values[36] = 1e-30f;
+
+		for (const FlashKernels* kernels : FlashKernels::GetSupported())
+		{
+			EXPECT_EQ(4, kernels->countNonZero(values.data(), (int)values.size())) << kernels->name;
+		}
+	}
+}
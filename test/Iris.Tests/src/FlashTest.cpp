@@ -32,13 +32,13 @@ namespace iris::Tests
 		cv::Mat frame2(size, CV_32FC1, cv::Scalar(1.0f));
 		cv::Mat frame3(size, CV_32FC1, cv::Scalar(0.85f));
 
-		flash.SetCurrentFrame(&frame);
-		flash.SetCurrentFrame(&frame2);
+		flash.SetCurrentFrame(frame);
+		flash.SetCurrentFrame(frame2);
 
 		Flash::CheckTransitionResult res = flash.CheckTransition(0.2f, 0.0f);
 		EXPECT_FALSE(res.checkResult);
 
-		flash.SetCurrentFrame(&frame3);
+		flash.SetCurrentFrame(frame3);
 		flash.CheckTransition(-0.15f, 0.2f);
 		EXPECT_FALSE(res.checkResult);
 	}
@@ -53,13 +53,13 @@ namespace iris::Tests
 		cv::Mat frame2(size, CV_32FC1, cv::Scalar(1.0f));
 		cv::Mat frame3(size, CV_32FC1, cv::Scalar(0.4f));
 
-		flash.SetCurrentFrame(&frame);
-		flash.SetCurrentFrame(&frame2);
+		flash.SetCurrentFrame(frame);
+		flash.SetCurrentFrame(frame2);
 
 		Flash::CheckTransitionResult res = flash.CheckTransition(0.4f, 0.0f);
 		EXPECT_TRUE(res.checkResult);
 
-		flash.SetCurrentFrame(&frame3);
+		flash.SetCurrentFrame(frame3);
 		flash.CheckTransition(-0.6f, 0.4f);
 		EXPECT_TRUE(res.checkResult);
 	}
@@ -77,4 +77,28 @@ namespace iris::Tests
 
 		EXPECT_FALSE(res.checkResult);
 	}
+
+	TEST_F(FlashTest, Changed_Pixels_Match_Frame_Difference)
+	{
+		FpsFrameManager frameManager{};
+		cv::Size size(37, 21);
+		Flash flash(5, size, configuration.GetLuminanceFlashParams(), &frameManager);
+
+		cv::Mat frame(size, CV_32FC1, cv::Scalar(0.2f));
+		cv::Mat frame2 = frame.clone();
+		cv::rectangle(frame2, cv::Rect(3, 2, 20, 15), cv::Scalar(0.9f), cv::FILLED);
+
+		flash.SetCurrentFrame(frame);
+		EXPECT_EQ(0, flash.CountChangedPixels(cv::Range(0, size.height)));
+
+		flash.SetCurrentFrame(frame2);
+		int changed = flash.CountChangedPixels(cv::Range(0, size.height));
+		EXPECT_EQ(20 * 15, changed);
+		EXPECT_EQ(cv::countNonZero(flash.FrameDifference()), changed);
+
+		float avgDiff = flash.CheckSafeArea(flash.FrameDifference());
+		float flashArea = flash.GetFlashArea();
+		EXPECT_FLOAT_EQ(avgDiff, flash.CheckSafeArea(changed));
+		EXPECT_FLOAT_EQ(flashArea, flash.GetFlashArea());
+	}
 }
\ No newline at end of file
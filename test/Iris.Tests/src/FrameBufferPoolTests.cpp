@@ -0,0 +1,41 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include "FrameBufferPool.h"
+
+namespace iris::Tests
+{
+	TEST(FrameBufferPoolTests, Released_Buffer_Is_Reused)
+	{
+		FrameBufferPool pool(cv::Size(64, 48));
+
+		cv::Mat buffer = pool.Acquire(CV_32FC1);
+		ASSERT_EQ(cv::Size(64, 48), buffer.size());
+		ASSERT_EQ(CV_32FC1, buffer.type());
+		const uchar* data = buffer.data;
+		buffer.release();
+
+		cv::Mat reused = pool.Acquire(CV_32FC1);
+		EXPECT_EQ(data, reused.data);
+		EXPECT_EQ(1, pool.Size());
+	}
+
+	TEST(FrameBufferPoolTests, Held_Buffer_Is_Not_Reused)
+	{
+		FrameBufferPool pool(cv::Size(64, 48));
+
+		cv::Mat first = pool.Acquire(CV_32FC1);
+		cv::Mat shared = first; //a second header keeps the buffer in use
+		first.release();
+
+		cv::Mat second = pool.Acquire(CV_32FC1);
+		EXPECT_NE(shared.data, second.data);
+
+		//buffers of other types or sizes are not handed out
+		cv::Mat color = pool.Acquire(CV_32FC3);
+		cv::Mat small = pool.Acquire(cv::Size(32, 24), CV_32FC1);
+		EXPECT_EQ(CV_32FC3, color.type());
+		EXPECT_EQ(cv::Size(32, 24), small.size());
+		EXPECT_EQ(4, pool.Size());
+	}
+}
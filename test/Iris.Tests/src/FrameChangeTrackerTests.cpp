@@ -0,0 +1,86 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include "FrameChangeTracker.h"
+#include <algorithm>
+
+namespace iris::Tests
+{
+	TEST(FrameChangeTrackerTests, Bgr_Repeats)
+	{
+		FrameChangeTracker tracker;
+		cv::Mat frame(cv::Size(33, 17), CV_8UC3, cv::Scalar(10, 20, 30));
+
+		EXPECT_FALSE(tracker.IsRepeated(frame)); //first frame
+		EXPECT_TRUE(tracker.IsRepeated(frame.clone()));
+
+		cv::Mat changed = frame.clone();
+		changed.at<cv::Vec3b>(16, 32)[2] = 31; //last byte of the frame
+		EXPECT_FALSE(tracker.IsRepeated(changed));
+		EXPECT_TRUE(tracker.IsRepeated(changed));
+
+		//views of a bigger frame are compared by rows
+		cv::Mat bigger(cv::Size(40, 20), CV_8UC3, cv::Scalar(0, 0, 0));
+		cv::Mat view = bigger(cv::Rect(2, 1, 33, 17));
+		changed.copyTo(view);
+		EXPECT_TRUE(tracker.IsRepeated(view));
+
+		EXPECT_FALSE(tracker.IsRepeated(bigger)); //different size
+
+		tracker.Reset();
+		EXPECT_FALSE(tracker.IsRepeated(bigger));
+	}
+
+	TEST(FrameChangeTrackerTests, Yuv_Repeats)
+	{
+		FrameChangeTracker tracker;
+		YuvFrame frame;
+		frame.y = cv::Mat(cv::Size(16, 8), CV_8UC1, cv::Scalar(100));
+		frame.u = cv::Mat(cv::Size(8, 4), CV_8UC1, cv::Scalar(128));
+		frame.v = cv::Mat(cv::Size(8, 4), CV_8UC1, cv::Scalar(128));
+
+		EXPECT_FALSE(tracker.IsRepeated(frame));
+		EXPECT_TRUE(tracker.IsRepeated(frame));
+
+		//only the chroma changes
+		YuvFrame changed = frame;
+		changed.v = frame.v.clone();
+		changed.v.at<uchar>(3, 7) = 129;
+		EXPECT_FALSE(tracker.IsRepeated(changed));
+		EXPECT_TRUE(tracker.IsRepeated(changed));
+	}
+
+	TEST(FrameChangeTrackerTests, Yuv_Tiles)
+	{
+		FrameChangeTracker tracker;
+		YuvFrame frame;
+		frame.y = cv::Mat(cv::Size(130, 70), CV_8UC1, cv::Scalar(60));
+		frame.u = cv::Mat(cv::Size(65, 35), CV_8UC1, cv::Scalar(128));
+		frame.v = cv::Mat(cv::Size(65, 35), CV_8UC1, cv::Scalar(128));
+
+		FrameTiles tiles;
+		EXPECT_FALSE(tracker.IsRepeated(frame, tiles)); //first frame
+		ASSERT_EQ(frame.size(), tiles.frameSize);
+		EXPECT_TRUE(tracker.IsRepeated(frame, tiles));
+		EXPECT_EQ(0, std::count(tiles.changed.begin(), tiles.changed.end(), 1));
+
+		//a fade changes every tile
+		YuvFrame fade = frame;
+		fade.y = cv::Mat(frame.y.size(), CV_8UC1, cv::Scalar(80));
+		EXPECT_FALSE(tracker.IsRepeated(fade, tiles));
+		EXPECT_EQ(tiles.Count(), std::count(tiles.changed.begin(), tiles.changed.end(), 1));
+
+		//a red flash only in the chroma of the last tile
+		YuvFrame flash = fade;
+		flash.v = fade.v.clone();
+		flash.v.at<uchar>(34, 64) = 240;
+		EXPECT_FALSE(tracker.IsRepeated(flash, tiles));
+		for (int tile = 0; tile < tiles.Count(); tile++)
+		{
+			EXPECT_EQ(tile == tiles.Count() - 1 ? 1 : 0, tiles.changed[tile]) << "Tile: " << tile;
+		}
+
+		EXPECT_TRUE(tracker.IsRepeated(flash, tiles));
+		EXPECT_EQ(0, std::count(tiles.changed.begin(), tiles.changed.end(), 1));
+	}
+}
@@ -0,0 +1,54 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "FrameQueue.h"
+
+namespace iris::Tests
+{
+	TEST(FrameQueueTests, Order_Is_Preserved)
+	{
+		FrameQueue<int> queue(2);
+		std::thread producer([&]()
+		{
+			for (int i = 0; i < 100; i++)
+			{
+				queue.Push(std::move(i));
+			}
+			queue.Close();
+		});
+
+		std::vector<int> consumed;
+		int value;
+		while (queue.Pop(value))
+		{
+			consumed.push_back(value);
+		}
+		producer.join();
+
+		ASSERT_EQ(100, consumed.size());
+		for (int i = 0; i < 100; i++)
+		{
+			EXPECT_EQ(i, consumed[i]);
+		}
+	}
+
+	TEST(FrameQueueTests, Close_Releases_Producer)
+	{
+		FrameQueue<int> queue(1);
+		EXPECT_TRUE(queue.Push(0));
+
+		std::thread producer([&]()
+		{
+			EXPECT_FALSE(queue.Push(1)); //blocked until the queue is closed
+		});
+		queue.Close();
+		producer.join();
+
+		int value;
+		EXPECT_TRUE(queue.Pop(value)); //remaining elements can still be drained
+		EXPECT_EQ(0, value);
+		EXPECT_FALSE(queue.Pop(value));
+	}
+}
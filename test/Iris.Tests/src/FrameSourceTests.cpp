@@ -0,0 +1,107 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include "IrisLibTest.h"
+#include <opencv2/videoio.hpp>
+#include "FFmpegFrameSource.h"
+#include "OpenCvFrameSource.h"
+#include "YuvFrame.h"
+
+namespace iris::Tests
+{
+	class FrameSourceTests : public IrisLibTest {
+	protected:
+		void SetUp() override
+		{
+			IrisLibTest::SetUp();
+		}
+	};
+
+	TEST_F(FrameSourceTests, FFmpeg_Open_Invalid_File)
+	{
+		FFmpegFrameSource frameSource;
+		EXPECT_FALSE(frameSource.Open("data/TestVideos/missing.mp4"));
+
+		cv::Mat frame;
+		EXPECT_FALSE(frameSource.Read(frame));
+	}
+
+	TEST_F(FrameSourceTests, FFmpeg_Matches_VideoCapture)
+	{
+		const char* sourceVideo = "data/TestVideos/2Hz_5s.mp4";
+
+		FFmpegFrameSource ffmpegSource(2);
+		ASSERT_TRUE(ffmpegSource.Open(sourceVideo));
+
+		OpenCvFrameSource openCvSource(sourceVideo);
+		cv::VideoCapture& video = openCvSource.GetVideoCapture();
+		ASSERT_TRUE(video.isOpened());
+
+		EXPECT_EQ((int)video.get(cv::CAP_PROP_FRAME_COUNT), ffmpegSource.GetFrameCount());
+		EXPECT_EQ(cv::Size(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT)), ffmpegSource.GetFrameSize());
+
+		cv::Mat ffmpegFrame, openCvFrame;
+		int numFrames = 0;
+		while (ffmpegSource.Read(ffmpegFrame))
+		{
+			ASSERT_TRUE(openCvSource.Read(openCvFrame));
+			ASSERT_EQ(CV_8UC3, ffmpegFrame.type());
+			ASSERT_EQ(openCvFrame.size(), ffmpegFrame.size());
+
+			//both decoders convert to BGR with swscale, small differences are allowed
+			EXPECT_LE(cv::norm(openCvFrame, ffmpegFrame, cv::NORM_INF), 2) << "Frame: " << numFrames;
+			numFrames++;
+		}
+
+		EXPECT_FALSE(openCvSource.Read(openCvFrame));
+		EXPECT_EQ(ffmpegSource.GetFrameCount(), numFrames);
+	}
+
+	TEST_F(FrameSourceTests, FFmpeg_Decoder_Downscale)
+	{
+		const char* sourceVideo = "data/TestVideos/2Hz_5s.mp4";
+
+		FFmpegFrameSource frameSource;
+		ASSERT_TRUE(frameSource.Open(sourceVideo, 0.5f));
+
+		cv::Size frameSize = frameSource.GetFrameSize();
+		cv::Size outputSize(frameSize.width * 0.5f, frameSize.height * 0.5f);
+		EXPECT_EQ(outputSize, frameSource.GetOutputSize());
+
+		cv::Mat frame;
+		ASSERT_TRUE(frameSource.Read(frame));
+		EXPECT_EQ(outputSize, frame.size());
+
+		YuvFrame yuvFrame;
+		ASSERT_TRUE(frameSource.Read(yuvFrame));
+		EXPECT_EQ(outputSize, yuvFrame.size());
+		EXPECT_EQ(cv::Size((outputSize.width + 1) / 2, (outputSize.height + 1) / 2), yuvFrame.u.size());
+	}
+
+	TEST_F(FrameSourceTests, FFmpeg_Seek_Matches_Sequential_Read)
+	{
+		const char* sourceVideo = "data/TestVideos/2Hz_5s.mp4";
+
+		std::vector<cv::Mat> frames;
+		FFmpegFrameSource sequentialSource;
+		ASSERT_TRUE(sequentialSource.Open(sourceVideo));
+		cv::Mat frame;
+		while (sequentialSource.Read(frame))
+		{
+			frames.push_back(frame.clone());
+		}
+		ASSERT_GT(frames.size(), 100);
+
+		for (int frameIndex : { 0, 1, 47, 100, (int)frames.size() - 1 })
+		{
+			FFmpegFrameSource frameSource;
+			ASSERT_TRUE(frameSource.Open(sourceVideo));
+			ASSERT_TRUE(frameSource.Seek(frameIndex));
+			ASSERT_TRUE(frameSource.Read(frame));
+			EXPECT_EQ(0, cv::norm(frames[frameIndex], frame, cv::NORM_INF)) << "Frame: " << frameIndex;
+		}
+
+		FFmpegFrameSource frameSource;
+		ASSERT_TRUE(frameSource.Open(sourceVideo));
+		EXPECT_FALSE(frameSource.Seek(frames.size() + 10));
+	}
+}
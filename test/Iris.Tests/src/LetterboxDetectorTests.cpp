@@ -0,0 +1,37 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include "LetterboxDetector.h"
+
+namespace iris::Tests
+{
+	TEST(LetterboxDetectorTests, Content_Area)
+	{
+		LetterboxDetector detector(4, 2);
+		const cv::Rect fullFrame(0, 0, 40, 30);
+		cv::Mat frame(fullFrame.size(), CV_8UC3, cv::Scalar(0, 0, 0));
+
+		//black frames are not probed
+		EXPECT_EQ(fullFrame, detector.Update(frame));
+
+		//letterbox with near black border noise
+		frame.setTo(cv::Scalar(3, 4, 2));
+		frame(cv::Rect(0, 5, 40, 20)).setTo(cv::Scalar(50, 60, 70));
+		EXPECT_EQ(fullFrame, detector.Update(frame));
+		frame.at<cv::Vec3b>(24, 39)[0] = 0; //content pixels can be black
+		EXPECT_EQ(cv::Rect(0, 5, 40, 20), detector.Update(frame));
+		EXPECT_EQ(cv::Rect(0, 5, 40, 20), detector.Update(frame));
+
+		//content in the borders grows the area
+		frame.at<cv::Vec3b>(27, 10)[2] = 5;
+		EXPECT_EQ(cv::Rect(0, 5, 40, 23), detector.Update(frame));
+		frame.at<cv::Vec3b>(27, 10)[2] = 0;
+		EXPECT_EQ(cv::Rect(0, 5, 40, 23), detector.Update(frame));
+
+		//a new frame size is probed again
+		cv::Mat pillarbox(cv::Size(32, 16), CV_8UC3, cv::Scalar(0, 0, 0));
+		pillarbox(cv::Rect(4, 0, 24, 16)).setTo(cv::Scalar(255, 255, 255));
+		EXPECT_EQ(cv::Rect(0, 0, 32, 16), detector.Update(pillarbox));
+		EXPECT_EQ(cv::Rect(4, 0, 24, 16), detector.Update(pillarbox));
+	}
+}
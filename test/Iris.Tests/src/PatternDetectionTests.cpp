@@ -9,6 +9,7 @@
 #include "iris/TotalFlashIncidents.h"
 #include "FpsFrameManager.h"
 #include "TimeFrameManager.h"
+#include "ExclusionMask.h"
 
 namespace iris::Tests
 {
@@ -33,7 +34,9 @@ protected:
 TEST_F(PatternDetectionTests, NoPattern_Pass)
 {
 	cv::Mat image = cv::imread("data/TestImages/Patterns/shapes.png");
-	IrisFrame irisFrame(&image, frameRgbConverter->Convert(image), FrameData());
+	cv::Mat imageSrgb;
+	frameRgbConverter->Convert(image, imageSrgb);
+	IrisFrame irisFrame(&image, &imageSrgb, FrameData());
 	FpsFrameManager frameManager{};
 
 	FlashDetection flashDetection(&configuration, 0, image.size(), &frameManager);
@@ -48,15 +51,15 @@ TEST_F(PatternDetectionTests, NoPattern_Pass)
 	}
 
 	EXPECT_EQ(PatternResult::Pass, data.patternFrameResult);
-
-	irisFrame.Release();
 }
 
 
 TEST_F(PatternDetectionTests, Straight_Lines_Fail)
 {
 	cv::Mat image = cv::imread("data/TestImages/Patterns/20stripes.png");
-	IrisFrame irisFrame(&image, frameRgbConverter->Convert(image), FrameData());
+	cv::Mat imageSrgb;
+	frameRgbConverter->Convert(image, imageSrgb);
+	IrisFrame irisFrame(&image, &imageSrgb, FrameData());
 	FpsFrameManager frameManager{};
 	
 	FlashDetection flashDetection(&configuration, 0, image.size(), &frameManager);
@@ -71,14 +74,14 @@ TEST_F(PatternDetectionTests, Straight_Lines_Fail)
 	}
 
 	EXPECT_EQ(PatternResult::Fail, data.patternFrameResult);
-
-	irisFrame.Release();
 }
 
 TEST_F(PatternDetectionTests, RealTime_NoPattern_Pass)
 {
 	cv::Mat image = cv::imread("data/TestImages/Patterns/shapes.png");
-	IrisFrame irisFrame(&image, frameRgbConverter->Convert(image), FrameData());
+	cv::Mat imageSrgb;
+	frameRgbConverter->Convert(image, imageSrgb);
+	IrisFrame irisFrame(&image, &imageSrgb, FrameData());
 	TimeFrameManager frameManager{};
 
 	FlashDetection flashDetection(&configuration, 0, image.size(), &frameManager);
@@ -94,15 +97,15 @@ TEST_F(PatternDetectionTests, RealTime_NoPattern_Pass)
 	}
 
 	EXPECT_EQ(PatternResult::Pass, data.patternFrameResult);
-
-	irisFrame.Release();
 }
 
 
 TEST_F(PatternDetectionTests, RealTime_Straight_Lines_Fail)
 {
 	cv::Mat image = cv::imread("data/TestImages/Patterns/20stripes.png");
-	IrisFrame irisFrame(&image, frameRgbConverter->Convert(image), FrameData());
+	cv::Mat imageSrgb;
+	frameRgbConverter->Convert(image, imageSrgb);
+	IrisFrame irisFrame(&image, &imageSrgb, FrameData());
 	TimeFrameManager frameManager{};
 
 	FlashDetection flashDetection(&configuration, 0, image.size(), &frameManager);
@@ -118,8 +121,209 @@ TEST_F(PatternDetectionTests, RealTime_Straight_Lines_Fail)
 	}
 
 	EXPECT_EQ(PatternResult::Fail, data.patternFrameResult);
+}
+
+TEST_F(PatternDetectionTests, Reused_Workspace_Same_Pattern)
+{
+	cv::Mat stripes = cv::imread("data/TestImages/Patterns/20stripes.png");
+	cv::Mat shapes = cv::imread("data/TestImages/Patterns/shapes.png");
+	cv::resize(shapes, shapes, stripes.size());
+	FpsFrameManager frameManager{};
+
+	FlashDetection flashDetection(&configuration, 0, stripes.size(), &frameManager);
+	PatternDetection patternDetection(&configuration, 5, stripes.size(), &frameManager);
+
+	//the FFT buffers of a frame must not change the result of the next frames
+	std::vector<FrameData> data(3);
+	const cv::Mat* frames[] = { &stripes, &shapes, &stripes };
+	for (int i = 0; i < 3; i++)
+	{
+		cv::Mat imageSrgb;
+		frameRgbConverter->Convert(*frames[i], imageSrgb);
+		IrisFrame irisFrame(frames[i], &imageSrgb, FrameData());
+		flashDetection.setLuminance(irisFrame);
+
+		frameManager.AddFrame(data[i]);
+		patternDetection.checkFrame(irisFrame, i, data[i]);
+	}
+
+	EXPECT_NE(FrameData().patternArea, data[0].patternArea);
+	EXPECT_EQ(data[0].patternArea, data[2].patternArea);
+	EXPECT_EQ(data[0].patternDetectedLines, data[2].patternDetectedLines);
+}
+
+TEST_F(PatternDetectionTests, FourierTransform_Reconstructs_Frame)
+{
+	cv::Mat frame(90, 160, CV_8UC1);
+	cv::randu(frame, 0, 256);
+	cv::Point center(frame.cols / 2, frame.rows / 2);
+	FourierTransform ft(center);
+
+	//without peaks the inverse of the real input transform is the frame
+	FourierTransform::DftComponents& dftComps = ft.getPSD(frame);
+	cv::Mat noPeaks = cv::Mat::zeros(dftComps.spectrum.size(), CV_8UC1);
+	ft.filterSpectrum(noPeaks, dftComps.spectrum);
+	const cv::Mat& ift = ft.getIFT(dftComps, frame.size());
+
+	ASSERT_EQ(frame.size(), ift.size());
+	EXPECT_LE(cv::norm(ift, frame, cv::NORM_INF), 1);
+}
+
+TEST_F(PatternDetectionTests, FourierTransform_Keeps_DC_Disk)
+{
+	cv::Mat frame(90, 160, CV_8UC1);
+	cv::randu(frame, 0, 256);
+	cv::Point center(frame.cols / 2, frame.rows / 2);
+	FourierTransform ft(center);
+
+	//every coefficient is a peak, only the disk around the DC term (the corners of the unshifted spectrum) is kept
+	FourierTransform::DftComponents& dftComps = ft.getPSD(frame);
+	cv::Mat spectrum = dftComps.spectrum.clone();
+	cv::Mat allPeaks(dftComps.spectrum.size(), CV_8UC1, cv::Scalar(255));
+	ft.filterSpectrum(allPeaks, dftComps.spectrum);
+
+	const cv::Point kept[] = { {0, 0}, {3, 0}, {0, 4}, {159, 0}, {0, 89}, {157, 87} };
+	for (const cv::Point& point : kept)
+	{
+		EXPECT_EQ(spectrum.at<cv::Vec2f>(point), dftComps.spectrum.at<cv::Vec2f>(point));
+	}
+	const cv::Point removed[] = { {6, 0}, {0, 6}, {80, 45}, {40, 20} };
+	for (const cv::Point& point : removed)
+	{
+		EXPECT_EQ(cv::Vec2f(0, 0), dftComps.spectrum.at<cv::Vec2f>(point));
+	}
+}
+
+TEST_F(PatternDetectionTests, Gate_Reuses_Pattern_Of_Unchanged_Frames)
+{
+	cv::Mat stripes = cv::imread("data/TestImages/Patterns/20stripes.png");
+	cv::Mat shapes = cv::imread("data/TestImages/Patterns/shapes.png");
+	cv::resize(shapes, shapes, stripes.size());
+	cv::Mat stripesCursor = stripes.clone();
+	cv::rectangle(stripesCursor, cv::Rect(100, 100, 16, 16), cv::Scalar(0, 0, 255), -1);
+	//the same stripes too dark to be harmful, their normalized luminance is nearly the same as the bright ones
+	cv::Mat dimStripes;
+	stripes.convertTo(dimStripes, -1, 0.2);
 
-	irisFrame.Release();
+	//a threshold above any difference reuses the first pattern, a small one only for nearly unchanged frames
+	for (float threshold : { 256.0f, 1.0f })
+	{
+		configuration.SetPatternGateThreshold(threshold);
+		FpsFrameManager frameManager{};
+		FlashDetection flashDetection(&configuration, 0, stripes.size(), &frameManager);
+		PatternDetection patternDetection(&configuration, 5, stripes.size(), &frameManager);
+
+		std::vector<FrameData> data(5);
+		const cv::Mat* frames[] = { &stripes, &stripesCursor, &shapes, &dimStripes, &stripes };
+		for (int i = 0; i < 5; i++)
+		{
+			cv::Mat imageSrgb;
+			frameRgbConverter->Convert(*frames[i], imageSrgb);
+			IrisFrame irisFrame(frames[i], &imageSrgb, FrameData());
+			flashDetection.setLuminance(irisFrame);
+
+			frameManager.AddFrame(data[i]);
+			patternDetection.checkFrame(irisFrame, i, data[i]);
+		}
+
+		EXPECT_EQ(data[0].patternArea, data[1].patternArea);
+		EXPECT_EQ(threshold > 255, data[0].patternArea == data[2].patternArea);
+		if (threshold < 255)
+		{
+			//the stripes brightening across the harmful luminance are analysed again
+			EXPECT_EQ(FrameData().patternArea, data[3].patternArea);
+			EXPECT_EQ(data[0].patternArea, data[4].patternArea);
+		}
+	}
+}
+
+TEST_F(PatternDetectionTests, Excluded_Area_Does_Not_Change_Pattern)
+{
+	cv::Mat stripes = cv::imread("data/TestImages/Patterns/20stripes.png");
+	FpsFrameManager frameManager{};
+	FlashDetection flashDetection(&configuration, 0, stripes.size(), &frameManager);
+	PatternDetection patternDetection(&configuration, 5, stripes.size(), &frameManager);
+
+	const cv::Rect hud(1400, 100, 400, 300);
+	ExclusionMask mask(stripes.size(), { hud });
+	patternDetection.setExclusionMask(&mask);
+
+	cv::Mat imageSrgb;
+	frameRgbConverter->Convert(stripes, imageSrgb);
+	IrisFrame irisFrame(&stripes, &imageSrgb, FrameData());
+	flashDetection.setLuminance(irisFrame);
+
+	//excluded pixels are 0 after the conversion, their content must not change the pattern of the analysed area
+	std::vector<FrameData> data(2);
+	const float excludedLuminance[] = { 0.0f, 1.0f };
+	for (int i = 0; i < 2; i++)
+	{
+		cv::Mat luminance = irisFrame.luminanceFrame->clone();
+		luminance(hud).setTo(excludedLuminance[i]);
+		IrisFrame excludedFrame = irisFrame;
+		excludedFrame.luminanceFrame = &luminance;
+
+		frameManager.AddFrame(data[i]);
+		patternDetection.checkFrame(excludedFrame, i, data[i]);
+	}
+
+	EXPECT_NE(FrameData().patternArea, data[0].patternArea);
+	EXPECT_EQ(data[0].patternArea, data[1].patternArea);
+	EXPECT_EQ(data[0].patternDetectedLines, data[1].patternDetectedLines);
 }
 
-}
\ No newline at end of file
+TEST_F(PatternDetectionTests, Workers_Commit_Results_In_Frame_Order)
+{
+	cv::Mat stripes = cv::imread("data/TestImages/Patterns/20stripes.png");
+	cv::Mat shapes = cv::imread("data/TestImages/Patterns/shapes.png");
+	cv::resize(shapes, shapes, stripes.size());
+	const cv::Mat* frames[] = { &stripes, &shapes, &stripes, &stripes, &stripes, &shapes, &stripes, &stripes };
+	const int frameCount = 8;
+
+	//the results committed by the workers are the ones of checkFrame
+	std::vector<FrameData> expected(frameCount), data(frameCount);
+	for (unsigned int workers : { 0u, 3u })
+	{
+		FpsFrameManager frameManager{};
+		FlashDetection flashDetection(&configuration, 0, stripes.size(), &frameManager);
+		PatternDetection patternDetection(&configuration, 5, stripes.size(), &frameManager);
+		patternDetection.setWorkers(workers);
+
+		std::vector<FrameData>& results = workers > 0 ? data : expected;
+		size_t committed = 0;
+		for (int i = 0; i < frameCount; i++)
+		{
+			cv::Mat imageSrgb;
+			frameRgbConverter->Convert(*frames[i], imageSrgb);
+			IrisFrame irisFrame(frames[i], &imageSrgb, FrameData());
+			flashDetection.setLuminance(irisFrame);
+
+			frameManager.AddFrame(results[i]);
+			if (workers > 0)
+			{
+				patternDetection.submitFrame(irisFrame, i, results[i]);
+				committed += patternDetection.commitFrames(2);
+			}
+			else
+			{
+				patternDetection.checkFrame(irisFrame, i, results[i]);
+			}
+		}
+
+		if (workers > 0)
+		{
+			committed += patternDetection.commitFrames(0);
+			EXPECT_EQ((size_t)frameCount, committed);
+			EXPECT_EQ((size_t)0, patternDetection.pendingFrames());
+		}
+	}
+
+	for (int i = 0; i < frameCount; i++)
+	{
+		EXPECT_EQ(expected[i].patternArea, data[i].patternArea);
+		EXPECT_EQ(expected[i].patternDetectedLines, data[i].patternDetectedLines);
+		EXPECT_EQ(expected[i].patternFrameResult, data[i].patternFrameResult);
+	}
+}
+
+}
@@ -43,20 +43,15 @@ namespace iris::Tests
 		cv::Mat blackImageBgr(size, CV_8UC3, black);
 		cv::Mat* pBlackSrgb = frameRgbConverter->Convert(blackImageBgr);
 
-		redSaturation.SetCurrentFrame(pBlackSrgb);
-		redSaturation.SetCurrentFrame(pRedSrgb);
+		redSaturation.SetCurrentFrame(*pBlackSrgb);
+		redSaturation.SetCurrentFrame(*pRedSrgb);
 
-		cv::Mat* matDiff = redSaturation.FrameDifference();
+		const cv::Mat& matDiff = redSaturation.FrameDifference();
 
-		float testChangeValues = matDiff->at<float>(0, 0);
+		float testChangeValues = matDiff.at<float>(0, 0);
 
 		EXPECT_EQ(320, testChangeValues);
 
-		if (matDiff != nullptr) {
-			matDiff->release();
-			delete matDiff;
-		}
-
 		delete pRedSrgb;
 		delete pBlackSrgb;
 	}
@@ -70,20 +65,15 @@ namespace iris::Tests
 		cv::Mat blackImageBgr(size, CV_8UC3, black);
 		cv::Mat* pBlackSrgb = frameRgbConverter->Convert(blackImageBgr);
 
-		redSaturation.SetCurrentFrame(pRedSrgb);
-		redSaturation.SetCurrentFrame(pBlackSrgb);
+		redSaturation.SetCurrentFrame(*pRedSrgb);
+		redSaturation.SetCurrentFrame(*pBlackSrgb);
 
-		cv::Mat* matDiff = redSaturation.FrameDifference();
+		const cv::Mat& matDiff = redSaturation.FrameDifference();
 
-		float testChangeValues = matDiff->at<float>(0, 0);
+		float testChangeValues = matDiff.at<float>(0, 0);
 
 		EXPECT_EQ(-320, testChangeValues);
 
-		if (matDiff != nullptr) {
-			matDiff->release();
-			delete matDiff;
-		}
-
 		delete pRedSrgb;
 		delete pBlackSrgb;
 	}
@@ -99,22 +89,17 @@ namespace iris::Tests
 		cv::rectangle(redImageBgr, cv::Rect(20, 20, 30, 30), red, -1);
 		cv::Mat* pRedSrgb = frameRgbConverter->Convert(redImageBgr);
 
-		redSaturation.SetCurrentFrame(pBlackSrgb);
-		redSaturation.SetCurrentFrame(pRedSrgb);
+		redSaturation.SetCurrentFrame(*pBlackSrgb);
+		redSaturation.SetCurrentFrame(*pRedSrgb);
 
-		cv::Mat* matDiff = redSaturation.FrameDifference();
+		const cv::Mat& matDiff = redSaturation.FrameDifference();
 
-		float testChangeValues = matDiff->at<float>(21, 21);
-		float testNullChangeValues = matDiff->at<float>(0, 0);
+		float testChangeValues = matDiff.at<float>(21, 21);
+		float testNullChangeValues = matDiff.at<float>(0, 0);
 
 		EXPECT_EQ(320, testChangeValues);
 		EXPECT_EQ(0, testNullChangeValues);
 
-		if (matDiff != nullptr) {
-			matDiff->release();
-			delete matDiff;
-		}
-
 		delete pRedSrgb;
 		delete pBlackSrgb;
 	}
@@ -131,22 +116,17 @@ namespace iris::Tests
 		cv::Mat* pRedSrgb = frameRgbConverter->Convert(redImageBgr);
 
 
-		redSaturation.SetCurrentFrame(pRedSrgb);
-		redSaturation.SetCurrentFrame(pBlackSrgb);
+		redSaturation.SetCurrentFrame(*pRedSrgb);
+		redSaturation.SetCurrentFrame(*pBlackSrgb);
 
-		cv::Mat* matDiff = redSaturation.FrameDifference();
+		const cv::Mat& matDiff = redSaturation.FrameDifference();
 
-		float testChangeValues = matDiff->at<float>(21, 21);
-		float testNullChangeValues = matDiff->at<float>(0, 0);
+		float testChangeValues = matDiff.at<float>(21, 21);
+		float testNullChangeValues = matDiff.at<float>(0, 0);
 
 		EXPECT_EQ(-320, testChangeValues);
 		EXPECT_EQ(0, testNullChangeValues);
 
-		if (matDiff != nullptr) {
-			matDiff->release();
-			delete matDiff;
-		}
-
 		delete pRedSrgb;
 		delete pBlackSrgb;
 	}
@@ -311,10 +291,10 @@ namespace iris::Tests
 		cv::Mat imageBgr(size, CV_8UC3, red);
 		cv::Mat* imageSbgr = frameRgbConverter->Convert(imageBgr);
 
-		redSaturation.SetCurrentFrame(imageSbgr);
-		redSaturation.SetCurrentFrame(imageSbgr);
+		redSaturation.SetCurrentFrame(*imageSbgr);
+		redSaturation.SetCurrentFrame(*imageSbgr);
 
-		cv::Mat* frameDiff = redSaturation.FrameDifference();
+		const cv::Mat& frameDiff = redSaturation.FrameDifference();
 		float avgDifference = redSaturation.CheckSafeArea(frameDiff);
 		EXPECT_EQ(0, avgDifference);
 
@@ -322,7 +302,6 @@ namespace iris::Tests
 		EXPECT_EQ(0, flashAreaProportion);
 
 		delete imageSbgr;
-		delete frameDiff;
 	}
 
 	TEST_F(RedSaturationTests, SafeArea_20_Percent_Change_Threshold)
@@ -342,13 +321,13 @@ namespace iris::Tests
 
 		cv::Mat imageBgr(size, CV_8UC3, blue);
 		cv::Mat* imageSbgr = frameRgbConverter->Convert(imageBgr);
-		redSaturation.SetCurrentFrame(imageSbgr);
+		redSaturation.SetCurrentFrame(*imageSbgr);
 
 		cv::Mat imageBgr2(size, CV_8UC3, red);
 		cv::Mat* imageSbgr2 = frameRgbConverter->Convert(imageBgr2);
-		redSaturation.SetCurrentFrame(imageSbgr2);
+		redSaturation.SetCurrentFrame(*imageSbgr2);
 
-		float avgDifference = redSaturation.CheckSafeArea(&frameDiff);
+		float avgDifference = redSaturation.CheckSafeArea(frameDiff);
 		EXPECT_EQ(0, avgDifference);
 
 		float flashAreaProportion = redSaturation.GetFlashArea();
@@ -365,13 +344,13 @@ namespace iris::Tests
 
 		cv::Mat imageBgr(size, CV_8UC3, blue);
 		cv::Mat* imageSbgr = frameRgbConverter->Convert(imageBgr);
-		redSaturation.SetCurrentFrame(imageSbgr);
+		redSaturation.SetCurrentFrame(*imageSbgr);
 
 		cv::Mat imageBgr2(size, CV_8UC3, red);
 		cv::Mat* imageSbgr2 = frameRgbConverter->Convert(imageBgr2);
-		redSaturation.SetCurrentFrame(imageSbgr2);
+		redSaturation.SetCurrentFrame(*imageSbgr2);
 
-		cv::Mat* frameDiff = redSaturation.FrameDifference();
+		const cv::Mat& frameDiff = redSaturation.FrameDifference();
 		float avgDifference = redSaturation.CheckSafeArea(frameDiff);
 		EXPECT_EQ(320, avgDifference);
 
@@ -380,6 +359,43 @@ namespace iris::Tests
 
 		delete imageSbgr;
 		delete imageSbgr2;
-		delete frameDiff;
 	}
-}
\ No newline at end of file
+
+	TEST_F(RedSaturationTests, Sparse_Frames_Match_Dense)
+	{
+		RedSaturation dense = GetRedSaturation(3);
+		RedSaturation sparse = GetRedSaturation(3);
+		sparse.SetSparseFramesEnabled(true);
+
+		std::vector<cv::Mat> framesBgr;
+		for (int i = 0; i < 5; i++)
+		{
+			framesBgr.emplace_back(size, CV_8UC3, black);
+		}
+		cv::rectangle(framesBgr[1], cv::Rect(20, 20, 30, 10), red, -1);
+		cv::rectangle(framesBgr[2], cv::Rect(30, 25, 30, 10), red, -1);
+		cv::rectangle(framesBgr[2], cv::Rect(80, 25, 5, 5), cv::Scalar(0, 40, 200), -1);
+		framesBgr[3].setTo(red); //dense frame
+		cv::rectangle(framesBgr[4], cv::Rect(0, 90, 100, 10), red, -1);
+
+		for (size_t i = 0; i < framesBgr.size() + 1; i++)
+		{
+			//the last frame is repeated
+			cv::Mat* sRgbFrame = frameRgbConverter->Convert(framesBgr[std::min(i, framesBgr.size() - 1)]);
+			dense.SetCurrentFrame(*sRgbFrame);
+			sparse.SetCurrentFrame(*sRgbFrame);
+
+			EXPECT_EQ(i != 3, sparse.getCurrentFrame().empty());
+			EXPECT_FLOAT_EQ(dense.GetFrameMean(), sparse.GetFrameMean());
+			EXPECT_EQ(dense.CountChangedPixels(cv::Range(0, size.height)), sparse.CountChangedPixels(cv::Range(0, size.height)));
+			EXPECT_EQ(dense.CountChangedPixels(cv::Rect(25, 20, 40, 12)), sparse.CountChangedPixels(cv::Rect(25, 20, 40, 12)));
+
+			cv::Mat denseDifference = dense.FrameDifference().clone();
+			if (i > 0)
+			{
+				EXPECT_EQ(0, cv::norm(denseDifference, sparse.FrameDifference(), cv::NORM_INF));
+			}
+			delete sRgbFrame;
+		}
+	}
+}
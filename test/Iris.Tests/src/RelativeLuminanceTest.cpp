@@ -8,6 +8,7 @@
 #include "IrisFrame.h"
 #include <limits>
 #include "FpsFrameManager.h"
+#include "FrameHistogram.h"
 
 namespace iris::Tests
 {
@@ -42,14 +43,14 @@ namespace iris::Tests
 		cv::Mat imageBgr(size, CV_8UC3, white);
 		
 		IrisFrame imagesRgb;
-		imagesRgb.sRgbFrame = frameRgbConverter->Convert(imageBgr);
+		cv::Mat imageBgrSrgb;
+		frameRgbConverter->Convert(imageBgr, imageBgrSrgb);
+		imagesRgb.sRgbFrame = &imageBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(imagesRgb);
-		cv::Mat* luminance = relativeLuminance.getCurrentFrame();
-		float testLum = luminance->at<float>(0, 0);
+		const cv::Mat& luminance = relativeLuminance.getCurrentFrame();
+		float testLum = luminance.at<float>(0, 0);
 		EXPECT_EQ(1, testLum);
-
-		imagesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, Luminance_WhenBlackFrame_Test)
@@ -58,14 +59,14 @@ namespace iris::Tests
 		cv::Mat imageBgr(size, CV_8UC3, black);
 		
 		IrisFrame imagesRgb;
-		imagesRgb.sRgbFrame = frameRgbConverter->Convert(imageBgr);
+		cv::Mat imageBgrSrgb;
+		frameRgbConverter->Convert(imageBgr, imageBgrSrgb);
+		imagesRgb.sRgbFrame = &imageBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(imagesRgb);
-		cv::Mat* luminance = relativeLuminance.getCurrentFrame();
-		float testLum = luminance->at<float>(0, 0);
+		const cv::Mat& luminance = relativeLuminance.getCurrentFrame();
+		float testLum = luminance.at<float>(0, 0);
 		EXPECT_EQ(0, testLum);
-
-		imagesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, Luminance_When_GrayFrame_Test)
@@ -74,15 +75,15 @@ namespace iris::Tests
 		cv::Mat imageBgr(size, CV_8UC3, gray);
 
 		IrisFrame imagesRgb;
-		imagesRgb.sRgbFrame = frameRgbConverter->Convert(imageBgr);
+		cv::Mat imageBgrSrgb;
+		frameRgbConverter->Convert(imageBgr, imageBgrSrgb);
+		imagesRgb.sRgbFrame = &imageBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(imagesRgb);
-		cv::Mat* luminance = relativeLuminance.getCurrentFrame();
-		float testLum = luminance->at<float>(0, 0);
+		const cv::Mat& luminance = relativeLuminance.getCurrentFrame();
+		float testLum = luminance.at<float>(0, 0);
 		testLum = RelativeLuminance::roundoff(testLum, 3);
 		EXPECT_EQ(0.216f, testLum);
-		
-		imagesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, Luminance_When_BlueFrame_Test)
@@ -91,15 +92,15 @@ namespace iris::Tests
 		cv::Mat imageBgr(size, CV_8UC3, blue);
 		
 		IrisFrame imagesRgb;
-		imagesRgb.sRgbFrame = frameRgbConverter->Convert(imageBgr);
+		cv::Mat imageBgrSrgb;
+		frameRgbConverter->Convert(imageBgr, imageBgrSrgb);
+		imagesRgb.sRgbFrame = &imageBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(imagesRgb);
-		cv::Mat* luminance = relativeLuminance.getCurrentFrame();
-		float testLum = luminance->at<float>(0, 0);
+		const cv::Mat& luminance = relativeLuminance.getCurrentFrame();
+		float testLum = luminance.at<float>(0, 0);
 		testLum = RelativeLuminance::roundoff(testLum, 3);
 		EXPECT_EQ(0.072f, testLum);
-
-		imagesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, TransitionBlackWhite_FrameDifference_Test)
@@ -107,20 +108,20 @@ namespace iris::Tests
 		RelativeLuminance relativeLuminance = GetLuminance(3);
 		cv::Mat imageWhiteBgr(size, CV_8UC3, white);
 		IrisFrame pImageWhitesRgb;
-		pImageWhitesRgb.sRgbFrame = frameRgbConverter->Convert(imageWhiteBgr);
+		cv::Mat imageWhiteBgrSrgb;
+		frameRgbConverter->Convert(imageWhiteBgr, imageWhiteBgrSrgb);
+		pImageWhitesRgb.sRgbFrame = &imageWhiteBgrSrgb;
 		cv::Mat imageBlackBgr(size, CV_8UC3, black);
 		IrisFrame pImagesBlackRgb;
-		pImagesBlackRgb.sRgbFrame = frameRgbConverter->Convert(imageBlackBgr);
+		cv::Mat imageBlackBgrSrgb;
+		frameRgbConverter->Convert(imageBlackBgr, imageBlackBgrSrgb);
+		pImagesBlackRgb.sRgbFrame = &imageBlackBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(pImagesBlackRgb);
 		relativeLuminance.SetCurrentFrame(pImageWhitesRgb);
-		cv::Mat* diff = relativeLuminance.FrameDifference();
-		float testLum = diff->at<float>(0, 0);
+		const cv::Mat& diff = relativeLuminance.FrameDifference();
+		float testLum = diff.at<float>(0, 0);
 		EXPECT_EQ(1, testLum);
-
-		delete diff;
-		pImagesBlackRgb.Release();
-		pImageWhitesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, TransitionWhiteBlack_FrameDifference_Test)
@@ -128,20 +129,20 @@ namespace iris::Tests
 		RelativeLuminance relativeLuminance = GetLuminance(3);
 		cv::Mat imageWhiteBgr(size, CV_8UC3, white);
 		IrisFrame pImageWhitesRgb;
-		pImageWhitesRgb.sRgbFrame = frameRgbConverter->Convert(imageWhiteBgr);
+		cv::Mat imageWhiteBgrSrgb;
+		frameRgbConverter->Convert(imageWhiteBgr, imageWhiteBgrSrgb);
+		pImageWhitesRgb.sRgbFrame = &imageWhiteBgrSrgb;
 		cv::Mat imageBlackBgr(size, CV_8UC3, black);
 		IrisFrame pImagesBlackRgb;
-		pImagesBlackRgb.sRgbFrame = frameRgbConverter->Convert(imageBlackBgr);
+		cv::Mat imageBlackBgrSrgb;
+		frameRgbConverter->Convert(imageBlackBgr, imageBlackBgrSrgb);
+		pImagesBlackRgb.sRgbFrame = &imageBlackBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(pImageWhitesRgb);
 		relativeLuminance.SetCurrentFrame(pImagesBlackRgb);
-		cv::Mat* diff = relativeLuminance.FrameDifference();
-		float testLum = diff->at<float>(0, 0);
+		const cv::Mat& diff = relativeLuminance.FrameDifference();
+		float testLum = diff.at<float>(0, 0);
 		EXPECT_EQ(-1, testLum);
-
-		delete diff;
-		pImagesBlackRgb.Release();
-		pImageWhitesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, TransitionWhiteBlackBlack_FrameDifference_Test)
@@ -149,21 +150,21 @@ namespace iris::Tests
 		RelativeLuminance relativeLuminance = GetLuminance(3);
 		cv::Mat imageWhiteBgr(size, CV_8UC3, white);
 		IrisFrame pImageWhitesRgb;
-		pImageWhitesRgb.sRgbFrame = frameRgbConverter->Convert(imageWhiteBgr);
+		cv::Mat imageWhiteBgrSrgb;
+		frameRgbConverter->Convert(imageWhiteBgr, imageWhiteBgrSrgb);
+		pImageWhitesRgb.sRgbFrame = &imageWhiteBgrSrgb;
 		cv::Mat imageBlackBgr(size, CV_8UC3, black);
 		IrisFrame pImagesBlackRgb;
-		pImagesBlackRgb.sRgbFrame = frameRgbConverter->Convert(imageBlackBgr);
+		cv::Mat imageBlackBgrSrgb;
+		frameRgbConverter->Convert(imageBlackBgr, imageBlackBgrSrgb);
+		pImagesBlackRgb.sRgbFrame = &imageBlackBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(pImageWhitesRgb);
 		relativeLuminance.SetCurrentFrame(pImagesBlackRgb);
 		relativeLuminance.SetCurrentFrame(pImagesBlackRgb);
-		cv::Mat* diff = relativeLuminance.FrameDifference();
-		float testLum = diff->at<float>(0, 0);
+		const cv::Mat& diff = relativeLuminance.FrameDifference();
+		float testLum = diff.at<float>(0, 0);
 		EXPECT_EQ(0, testLum);
-
-		delete diff;
-		pImagesBlackRgb.Release();
-		pImageWhitesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest,CheckTransition_WhenFalse_From_value_to_zero_Test)
@@ -314,13 +315,13 @@ namespace iris::Tests
 		RelativeLuminance relativeLuminance= GetLuminance(3);
 		cv::Mat imageWhiteBgr(size, CV_8UC3, white);
 		IrisFrame pImageWhitesRgb;
-		pImageWhitesRgb.sRgbFrame = frameRgbConverter->Convert(imageWhiteBgr);
+		cv::Mat imageWhiteBgrSrgb;
+		frameRgbConverter->Convert(imageWhiteBgr, imageWhiteBgrSrgb);
+		pImageWhitesRgb.sRgbFrame = &imageWhiteBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(pImageWhitesRgb);
 		float avgLum = relativeLuminance.FrameMean();
 		EXPECT_EQ(1, avgLum);
-		
-		pImageWhitesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, AverageLuminance_WhenGray_Test)
@@ -328,13 +329,13 @@ namespace iris::Tests
 		RelativeLuminance relativeLuminance = GetLuminance(3);
 		cv::Mat imageWhiteBgr(size, CV_8UC3, gray);
 		IrisFrame pImageWhitesRgb;
-		pImageWhitesRgb.sRgbFrame = frameRgbConverter->Convert(imageWhiteBgr);
+		cv::Mat imageWhiteBgrSrgb;
+		frameRgbConverter->Convert(imageWhiteBgr, imageWhiteBgrSrgb);
+		pImageWhitesRgb.sRgbFrame = &imageWhiteBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(pImageWhitesRgb);
 		float avgLum = relativeLuminance.roundoff(relativeLuminance.FrameMean(), 2);
 		EXPECT_EQ(0.22f, avgLum);
-
-		pImageWhitesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, AverageLuminance_WhenRealFrame_Test)
@@ -342,13 +343,13 @@ namespace iris::Tests
 		RelativeLuminance relativeLuminance = GetLuminance(3);
 		cv::Mat frameBgr = cv::imread("data/TestImages/frames/FrameForTest.jpg");
 		IrisFrame pFramesRgb;
-		pFramesRgb.sRgbFrame = frameRgbConverter->Convert(frameBgr);
+		cv::Mat frameBgrSrgb;
+		frameRgbConverter->Convert(frameBgr, frameBgrSrgb);
+		pFramesRgb.sRgbFrame = &frameBgrSrgb;
 
 		relativeLuminance.SetCurrentFrame(pFramesRgb);
 		float avgLum = relativeLuminance.roundoff(relativeLuminance.FrameMean(), 2);
 		EXPECT_EQ(0.33f, avgLum);
-
-		pFramesRgb.Release();
 	}
 
 	TEST_F(RelativeLuminanceTest, SafeArea_No_Change_Threshold)
@@ -359,10 +360,10 @@ namespace iris::Tests
 		cv::Mat imageBgr(testSize, CV_8UC3, blue);
 		cv::Mat* imageSbgr = frameRgbConverter->Convert(imageBgr);
 
-		luminance.SetCurrentFrame(imageSbgr);
-		luminance.SetCurrentFrame(imageSbgr);
+		luminance.SetCurrentFrame(*imageSbgr);
+		luminance.SetCurrentFrame(*imageSbgr);
 
-		cv::Mat* frameDiff = luminance.FrameDifference();
+		const cv::Mat& frameDiff = luminance.FrameDifference();
 		float avgDifference = luminance.CheckSafeArea(frameDiff);
 		EXPECT_EQ(0, avgDifference);
 
@@ -370,7 +371,6 @@ namespace iris::Tests
 		EXPECT_EQ(0, flashAreaProportion);
 
 		delete imageSbgr;
-		delete frameDiff;
 	}
 
 	TEST_F(RelativeLuminanceTest, SafeArea_20_Percent_Change_Threshold)
@@ -390,13 +390,13 @@ namespace iris::Tests
 
 		cv::Mat imageBgr(testSize, CV_8UC3, blue);
 		cv::Mat* imageSbgr = frameRgbConverter->Convert(imageBgr);
-		luminance.SetCurrentFrame(imageSbgr);
+		luminance.SetCurrentFrame(*imageSbgr);
 
 		cv::Mat imageBgr2(testSize, CV_8UC3, white);
 		cv::Mat* imageSbgr2 = frameRgbConverter->Convert(imageBgr2);
-		luminance.SetCurrentFrame(imageSbgr2);
+		luminance.SetCurrentFrame(*imageSbgr2);
 
-		float avgDifference = luminance.CheckSafeArea(&frameDiff);
+		float avgDifference = luminance.CheckSafeArea(frameDiff);
 		EXPECT_EQ(0, avgDifference);
 
 		float flashAreaProportion = luminance.GetFlashArea();
@@ -413,13 +413,13 @@ namespace iris::Tests
 
 		cv::Mat imageBgr(testSize, CV_8UC3, blue);
 		cv::Mat* imageSbgr = frameRgbConverter->Convert(imageBgr);
-		luminance.SetCurrentFrame(imageSbgr);
+		luminance.SetCurrentFrame(*imageSbgr);
 
 		cv::Mat imageBgr2(testSize, CV_8UC3, white);
 		cv::Mat* imageSbgr2 = frameRgbConverter->Convert(imageBgr2);
-		luminance.SetCurrentFrame(imageSbgr2);
+		luminance.SetCurrentFrame(*imageSbgr2);
 
-		cv::Mat* frameDiff = luminance.FrameDifference();
+		const cv::Mat& frameDiff = luminance.FrameDifference();
 		float avgDifference = luminance.CheckSafeArea(frameDiff);
 		EXPECT_TRUE(CompareFloat(0.9278, avgDifference));
 
@@ -428,6 +428,76 @@ namespace iris::Tests
 
 		delete imageSbgr;
 		delete imageSbgr2;
-		delete frameDiff;
 	}
-}
\ No newline at end of file
+
+	TEST_F(RelativeLuminanceTest, Frame_Mean_From_Histogram_Test)
+	{
+		RelativeLuminance relativeLuminance = GetLuminance(3, { 64, 48 });
+		cv::Mat imageBgr(cv::Size(64, 48), CV_8UC3);
+		cv::randu(imageBgr, cv::Scalar::all(0), cv::Scalar::all(256));
+
+		IrisFrame irisFrame;
+		cv::Mat imageSrgb;
+		frameRgbConverter->Convert(imageBgr, imageSrgb);
+		irisFrame.sRgbFrame = &imageSrgb;
+		relativeLuminance.SetCurrentFrame(irisFrame);
+
+		FrameHistogram histogram(configuration.GetFrameSrgbConverterParams()->values);
+		histogram.Calculate(imageBgr);
+		EXPECT_NEAR(relativeLuminance.GetFrameMean(), RelativeLuminance::FrameMean(histogram), 1e-5);
+	}
+
+	TEST_F(RelativeLuminanceTest, Repeated_Frame_Test)
+	{
+		RelativeLuminance relativeLuminance = GetLuminance(3, { 64, 48 });
+		cv::Mat imageBgr(cv::Size(64, 48), CV_8UC3, gray);
+
+		IrisFrame irisFrame;
+		cv::Mat imageSrgb;
+		frameRgbConverter->Convert(imageBgr, imageSrgb);
+		irisFrame.sRgbFrame = &imageSrgb;
+		relativeLuminance.SetCurrentFrame(irisFrame);
+		float frameMean = relativeLuminance.GetFrameMean();
+
+		IrisFrame repeatedFrame;
+		repeatedFrame.repeatedFrame = true;
+		relativeLuminance.SetCurrentFrame(repeatedFrame);
+
+		EXPECT_EQ(frameMean, relativeLuminance.GetFrameMean());
+		EXPECT_EQ(0, relativeLuminance.CountChangedPixels(cv::Range(0, 48)));
+		EXPECT_EQ(0, relativeLuminance.CheckSafeArea(0));
+	}
+
+	TEST_F(RelativeLuminanceTest, Frame_Area_Test)
+	{
+		RelativeLuminance relativeLuminance = GetLuminance(3, { 64, 48 });
+		cv::Mat imageBgr(cv::Size(64, 48), CV_8UC3, black);
+		cv::Mat content = imageBgr(cv::Rect(0, 6, 64, 36));
+		content.setTo(white);
+
+		IrisFrame irisFrame;
+		cv::Mat imageSrgb;
+		frameRgbConverter->Convert(imageBgr, imageSrgb);
+		irisFrame.sRgbFrame = &imageSrgb;
+		relativeLuminance.SetCurrentFrame(irisFrame);
+		float frameMean = relativeLuminance.GetFrameMean();
+
+		//the mean of the content area is relative to the full frame
+		relativeLuminance.SetFrameArea(cv::Rect(0, 6, 64, 36));
+		EXPECT_EQ(cv::Size(64, 36), relativeLuminance.getCurrentFrame().size());
+
+		cv::Mat contentSrgb;
+		frameRgbConverter->Convert(content, contentSrgb);
+		irisFrame.sRgbFrame = &contentSrgb;
+		relativeLuminance.SetCurrentFrame(irisFrame);
+		EXPECT_FLOAT_EQ(frameMean, relativeLuminance.GetFrameMean());
+		EXPECT_EQ(0, relativeLuminance.CountChangedPixels(cv::Range(0, 36)));
+
+		//the borders added to the area are black
+		relativeLuminance.SetFrameArea(cv::Rect(0, 0, 64, 48));
+		irisFrame.sRgbFrame = &imageSrgb;
+		relativeLuminance.SetCurrentFrame(irisFrame);
+		EXPECT_FLOAT_EQ(frameMean, relativeLuminance.GetFrameMean());
+		EXPECT_EQ(0, relativeLuminance.CountChangedPixels(cv::Range(0, 48)));
+	}
+}
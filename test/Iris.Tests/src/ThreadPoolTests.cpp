@@ -0,0 +1,40 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "ThreadPool.h"
+
+namespace iris::Tests
+{
+	TEST(ThreadPoolTests, All_Tasks_Are_Run)
+	{
+		ThreadPool pool(3);
+		std::atomic<int> sum = 0;
+
+		std::vector<std::future<void>> tasks;
+		for (int i = 1; i <= 100; i++)
+		{
+			tasks.emplace_back(pool.Enqueue([&sum, i]() { sum += i; }));
+		}
+		for (auto& task : tasks)
+		{
+			task.get();
+		}
+
+		EXPECT_EQ(5050, sum);
+	}
+
+	TEST(ThreadPoolTests, Task_Exception_Is_Rethrown)
+	{
+		ThreadPool pool(1);
+		auto task = pool.Enqueue([]() { throw std::runtime_error("task failed"); });
+		EXPECT_THROW(task.get(), std::runtime_error);
+
+		//workers keep running after a task has thrown
+		bool run = false;
+		pool.Enqueue([&run]() { run = true; }).get();
+		EXPECT_TRUE(run);
+	}
+}
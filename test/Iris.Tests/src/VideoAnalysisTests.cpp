@@ -5,7 +5,10 @@
 #include <opencv2/videoio.hpp>
 #include <fstream>
 #include <string>
+#include <sstream>
+#include <filesystem>
 #include "iris/FrameData.h"
+#include "iris/Result.h"
 
 namespace iris::Tests
 {
@@ -55,6 +58,26 @@ namespace iris::Tests
 			videoAnalyser.DeInit();
 		}
 	
+		//analyses the video with AnalyseVideo and returns the lines of its framedata.csv
+		std::vector<std::string> AnalyseVideoFrameData(const char* sourceVideo, const std::string& resultsPath, Result& result)
+		{
+			std::filesystem::remove_all(resultsPath);
+			configuration.SetResultsPath(resultsPath);
+			{
+				VideoAnalyser videoAnalyser(&configuration);
+				videoAnalyser.AnalyseVideo(false, sourceVideo, &result);
+			}
+
+			std::vector<std::string> lines;
+			std::ifstream frameData(resultsPath + std::filesystem::path(sourceVideo).filename().string() + "/framedata.csv");
+			std::string line;
+			while (std::getline(frameData, line))
+			{
+				lines.push_back(line);
+			}
+			return lines;
+		}
+
 		void CheckFrameData(std::string& line, FrameData& data)
 		{
 			std::vector<std::string> logFrameData;
@@ -260,4 +283,166 @@ namespace iris::Tests
 			TestVideoAnalysis(videoAnalyser, video, "data/ExpectedVideoLogFiles/intermitentEF_RELATIVE.csv", true);
 		}
 	}
-}
\ No newline at end of file
+
+	TEST_F(VideoAnalysisTests, Duplicate_Frame_Detection_Video_Test)
+	{
+		//repeated frames are analysed with the results of the last frame, the frame data is the same as without the detection
+		configuration.SetDuplicateFrameDetectionEnabled(true);
+		const std::pair<const char*, const char*> testVideos[] = {
+			{ "data/TestVideos/gray.mp4", "data/ExpectedVideoLogFiles/gray_RELATIVE.csv" },
+			{ "data/TestVideos/3Hz_6s.mp4", "data/ExpectedVideoLogFiles/3Hz_6s_RELATIVE.csv" },
+			{ "data/TestVideos/extendedFLONG.mp4", "data/ExpectedVideoLogFiles/extendedFLONG_RELATIVE.csv" } };
+
+		for (const auto& [sourceVideo, sourceLog] : testVideos)
+		{
+			VideoAnalyser videoAnalyser(&configuration);
+
+			cv::VideoCapture video(sourceVideo);
+			if (videoAnalyser.VideoIsOpen(sourceVideo, video))
+			{
+				TestVideoAnalysis(videoAnalyser, video, sourceLog);
+			}
+		}
+	}
+
+	TEST_F(VideoAnalysisTests, Parallel_Detection_Matches_Sequential)
+	{
+		const char* sourceVideo = "data/TestVideos/3Hz_6s.mp4";
+		configuration.SetPatternDetectionStatus(true);
+
+		VideoAnalyser videoAnalyser(&configuration);
+		VideoAnalyser parallelVideoAnalyser(&configuration);
+
+		cv::VideoCapture video(sourceVideo);
+		ASSERT_TRUE(videoAnalyser.VideoIsOpen(sourceVideo, video));
+		ASSERT_TRUE(parallelVideoAnalyser.VideoIsOpen(sourceVideo, video));
+
+		//the detectors are created on Init
+		configuration.SetParallelDetectionEnabled(false);
+		videoAnalyser.Init("./testVideo.mp4");
+		configuration.SetParallelDetectionEnabled(true);
+		parallelVideoAnalyser.Init("./testVideo.mp4");
+
+		cv::Mat frame;
+		unsigned int numFrames = 0;
+		while (video.read(frame))
+		{
+			FrameData data(numFrames + 1, 1000.0 * (double)numFrames / video.get(cv::CAP_PROP_FPS));
+			FrameData parallelData = data;
+			videoAnalyser.AnalyseFrame(frame, numFrames, data);
+			parallelVideoAnalyser.AnalyseFrame(frame, numFrames, parallelData);
+			numFrames++;
+
+			EXPECT_EQ(data.ToCSV(), parallelData.ToCSV()) << "Frame: " << data.Frame << '\n';
+		}
+
+		videoAnalyser.DeInit();
+		parallelVideoAnalyser.DeInit();
+	}
+
+	TEST_F(VideoAnalysisTests, Pipelined_Decoding_Matches_Sequential)
+	{
+		//frames decoded ahead in the decoder thread are analysed in the same order
+		const char* sourceVideo = "data/TestVideos/intermitentEF.mp4";
+		Result sequentialResult, pipelinedResult;
+		configuration.SetDecodeQueueSize(0);
+		std::vector<std::string> sequential = AnalyseVideoFrameData(sourceVideo, "TestResults/Sequential/", sequentialResult);
+		configuration.SetDecodeQueueSize(8);
+		std::vector<std::string> pipelined = AnalyseVideoFrameData(sourceVideo, "TestResults/Pipelined/", pipelinedResult);
+
+		ASSERT_GT(sequential.size(), 1u);
+		ASSERT_EQ(sequential.size(), pipelined.size());
+		for (size_t i = 0; i < sequential.size(); i++)
+		{
+			EXPECT_EQ(sequential[i], pipelined[i]) << "Line: " << i << '\n';
+		}
+		EXPECT_EQ(sequentialResult.OverallResult, pipelinedResult.OverallResult);
+		EXPECT_EQ(sequentialResult.Results, pipelinedResult.Results);
+	}
+
+	TEST_F(VideoAnalysisTests, Chunk_Analysis_Matches_Sequential)
+	{
+		//low frame rate so the video is long enough for the chunk warm-up windows
+		const char* sourceVideo = "data/TestVideos/chunks_5fps.avi";
+		{
+			cv::VideoWriter writer;
+			cv::Mat frame;
+			int frames = 0;
+			while (frames < 300)
+			{
+				cv::VideoCapture video(frames % 2 == 0 ? "data/TestVideos/3Hz_6s.mp4" : "data/TestVideos/intermitentEF.mp4");
+				while (frames < 300 && video.read(frame))
+				{
+					if (!writer.isOpened())
+					{
+						ASSERT_TRUE(writer.open(sourceVideo, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 5, frame.size()));
+					}
+					writer.write(frame);
+					frames++;
+				}
+			}
+		}
+
+		//chunks decode with FFmpeg, the sequential run must use the same decoder
+		configuration.SetFFmpegDecodingEnabled(true);
+		Result sequentialResult, chunkResult;
+		configuration.SetAnalysisChunks(0);
+		std::vector<std::string> sequential = AnalyseVideoFrameData(sourceVideo, "TestResults/Sequential/", sequentialResult);
+		configuration.SetAnalysisChunks(2);
+		std::vector<std::string> chunks = AnalyseVideoFrameData(sourceVideo, "TestResults/Chunks/", chunkResult);
+
+		ASSERT_EQ(301u, sequential.size());
+		ASSERT_EQ(sequential.size(), chunks.size());
+		for (size_t i = 0; i < sequential.size(); i++)
+		{
+			EXPECT_EQ(sequential[i], chunks[i]) << "Line: " << i << '\n';
+		}
+		EXPECT_EQ(sequentialResult.OverallResult, chunkResult.OverallResult);
+		EXPECT_EQ(sequentialResult.Results, chunkResult.Results);
+
+		std::filesystem::remove(sourceVideo);
+	}
+
+	TEST_F(VideoAnalysisTests, Chroma_Red_Saturation_Matches_Full_Resolution)
+	{
+		//the red flashes of the test videos cover areas larger than a 2x2 block, chroma resolution red saturation
+		//must find the same red transitions and incidents
+		const char* sourceVideos[] = { "data/TestVideos/GradualRedIncrease.mp4", "data/TestVideos/3Hz_6s.mp4",
+			"data/TestVideos/extendedFLONG.mp4", "data/TestVideos/intermitentEF.mp4", "data/TestVideos/flashStripes.mp4" };
+		configuration.SetYuvAnalysisEnabled(true);
+
+		for (const char* sourceVideo : sourceVideos)
+		{
+			Result lumaResult, chromaResult;
+			configuration.SetChromaRedSaturationEnabled(false);
+			std::vector<std::string> luma = AnalyseVideoFrameData(sourceVideo, "TestResults/LumaRed/", lumaResult);
+			configuration.SetChromaRedSaturationEnabled(true);
+			std::vector<std::string> chroma = AnalyseVideoFrameData(sourceVideo, "TestResults/ChromaRed/", chromaResult);
+
+			ASSERT_GT(luma.size(), 1u) << sourceVideo;
+			ASSERT_EQ(luma.size(), chroma.size()) << sourceVideo;
+			for (size_t i = 1; i < luma.size(); i++)
+			{
+				std::vector<std::string> lumaData, chromaData;
+				std::stringstream lumaLine(luma[i]), chromaLine(chroma[i]);
+				std::string value;
+				while (std::getline(lumaLine, value, ',')) { lumaData.push_back(value); }
+				while (std::getline(chromaLine, value, ',')) { chromaData.push_back(value); }
+
+				//red transitions, red extended fail count and red frame result
+				ASSERT_EQ(18u, lumaData.size()) << sourceVideo;
+				ASSERT_EQ(lumaData.size(), chromaData.size()) << sourceVideo;
+				EXPECT_EQ(lumaData[12], chromaData[12]) << sourceVideo << " Line: " << i << '\n';
+				EXPECT_EQ(lumaData[14], chromaData[14]) << sourceVideo << " Line: " << i << '\n';
+				EXPECT_EQ(lumaData[16], chromaData[16]) << sourceVideo << " Line: " << i << '\n';
+			}
+
+			EXPECT_EQ(lumaResult.OverallResult, chromaResult.OverallResult) << sourceVideo;
+			EXPECT_EQ(lumaResult.Results, chromaResult.Results) << sourceVideo;
+			EXPECT_EQ(lumaResult.totalRedIncidents.flashFailFrames, chromaResult.totalRedIncidents.flashFailFrames) << sourceVideo;
+			EXPECT_EQ(lumaResult.totalRedIncidents.extendedFailFrames, chromaResult.totalRedIncidents.extendedFailFrames) << sourceVideo;
+			EXPECT_EQ(lumaResult.totalRedIncidents.passWithWarningFrames, chromaResult.totalRedIncidents.passWithWarningFrames) << sourceVideo;
+			EXPECT_EQ(lumaResult.totalLuminanceIncidents.getTotalFailedFrames(), chromaResult.totalLuminanceIncidents.getTotalFailedFrames()) << sourceVideo;
+		}
+	}
+}
@@ -0,0 +1,188 @@
+//Copyright (C) 2024 Electronic Arts, Inc.  All rights reserved.
+
+#include <gtest/gtest.h>
+#include "IrisLibTest.h"
+#include "utils/FrameConverter.h"
+#include "YuvFrameConverter.h"
+#include "YuvFrame.h"
+#include "RelativeLuminance.h"
+#include "RedSaturation.h"
+#include "IrisFrame.h"
+#include "FpsFrameManager.h"
+
+namespace iris::Tests
+{
+	class YuvFrameConverterTests : public IrisLibTest {
+	protected:
+		EA::EACC::Utils::FrameConverter* frameRgbConverter = nullptr;
+		YuvFrameConverter* yuvConverter = nullptr;
+		IFrameManager* frameManager = nullptr;
+		cv::Size size{ 64, 48 };
+
+		void SetUp() override
+		{
+			IrisLibTest::SetUp();
+			frameRgbConverter = new EA::EACC::Utils::FrameConverter(configuration.GetFrameSrgbConverterParams());
+			yuvConverter = new YuvFrameConverter(configuration.GetFrameSrgbConverterParams());
+			frameManager = new FpsFrameManager();
+		}
+
+		~YuvFrameConverterTests() override
+		{
+			delete frameRgbConverter;
+			delete yuvConverter;
+			delete frameManager;
+		}
+
+		//BGR to video range BT.601 I420 frame
+		YuvFrame ToYuv(const cv::Mat& bgr)
+		{
+			cv::Mat i420;
+			cv::cvtColor(bgr, i420, cv::COLOR_BGR2YUV_I420);
+
+			YuvFrame frame;
+			frame.y = i420.rowRange(0, bgr.rows).clone();
+			frame.u = i420.rowRange(bgr.rows, bgr.rows + bgr.rows / 4).clone().reshape(1, bgr.rows / 2);
+			frame.v = i420.rowRange(bgr.rows + bgr.rows / 4, bgr.rows * 3 / 2).clone().reshape(1, bgr.rows / 2);
+			return frame;
+		}
+
+		//checks the YUV conversion against the BGR -> sRGB -> luminance/red saturation flow
+		void CompareWithBgr(const cv::Scalar& color)
+		{
+			cv::Mat bgr(size, CV_8UC3, color);
+
+			RelativeLuminance luminance(30, size, configuration.GetLuminanceFlashParams(), frameManager);
+			RedSaturation redSaturation(30, size, configuration.GetRedSaturationFlashParams(), frameManager);
+			cv::Mat bgrSrgb;
+			frameRgbConverter->Convert(bgr, bgrSrgb);
+			IrisFrame irisFrame(&bgr, &bgrSrgb, FrameData());
+			luminance.SetCurrentFrame(irisFrame);
+			redSaturation.SetCurrentFrame(irisFrame);
+
+			cv::Mat yuvLuminance, yuvRed;
+			yuvConverter->Convert(ToYuv(bgr), yuvLuminance, yuvRed);
+
+			ASSERT_EQ(size, yuvLuminance.size());
+			ASSERT_EQ(CV_32FC1, yuvLuminance.type());
+			ASSERT_EQ(CV_32FC1, yuvRed.type());
+
+			//8 bit rounding of the color conversion is the only difference
+			EXPECT_NEAR(luminance.GetFrameMean(), cv::mean(yuvLuminance)[0], 0.01);
+			EXPECT_NEAR(redSaturation.GetFrameMean(), cv::mean(yuvRed)[0], 5);
+
+		}
+	};
+
+	TEST_F(YuvFrameConverterTests, White_Frame)
+	{
+		CompareWithBgr(white);
+	}
+
+	TEST_F(YuvFrameConverterTests, Black_Frame)
+	{
+		cv::Mat yuvLuminance, yuvRed;
+		yuvConverter->Convert(ToYuv(cv::Mat(size, CV_8UC3, black)), yuvLuminance, yuvRed);
+
+		EXPECT_EQ(0, cv::countNonZero(yuvLuminance));
+		EXPECT_EQ(0, cv::countNonZero(yuvRed));
+	}
+
+	TEST_F(YuvFrameConverterTests, Gray_Frame)
+	{
+		CompareWithBgr(gray);
+	}
+
+	TEST_F(YuvFrameConverterTests, Red_Frame)
+	{
+		CompareWithBgr(red);
+	}
+
+	TEST_F(YuvFrameConverterTests, Blue_Frame)
+	{
+		CompareWithBgr(blue);
+	}
+
+	TEST_F(YuvFrameConverterTests, NV12_Matches_I420)
+	{
+		cv::Mat bgr(size, CV_8UC3, black);
+		cv::rectangle(bgr, cv::Rect(0, 0, size.width / 2, size.height), red, cv::FILLED);
+		YuvFrame i420 = ToYuv(bgr);
+
+		YuvFrame nv12 = i420;
+		nv12.layout = YuvFrame::Layout::NV12;
+		std::vector<cv::Mat> uv = { i420.u, i420.v };
+		cv::merge(uv, nv12.u);
+		nv12.v.release();
+
+		cv::Mat i420Luminance, i420Red, nv12Luminance, nv12Red;
+		yuvConverter->Convert(i420, i420Luminance, i420Red);
+		yuvConverter->Convert(nv12, nv12Luminance, nv12Red);
+
+		EXPECT_EQ(0, cv::norm(i420Luminance, nv12Luminance, cv::NORM_INF));
+		EXPECT_EQ(0, cv::norm(i420Red, nv12Red, cv::NORM_INF));
+	}
+
+	TEST_F(YuvFrameConverterTests, Chroma_Red_Saturation)
+	{
+		//2x2 blocks of the same color have the red saturation of their pixels at chroma resolution
+		cv::Mat bgr(size, CV_8UC3, black);
+		cv::rectangle(bgr, cv::Rect(0, 0, size.width / 2, size.height), red, cv::FILLED);
+		cv::rectangle(bgr, cv::Rect(size.width / 2, 0, size.width / 4, size.height / 2), gray, cv::FILLED);
+		YuvFrame frame = ToYuv(bgr);
+
+		cv::Mat luminance, lumaRed, chromaLuminance, chromaRed;
+		float luminanceMean, lumaRedMean, chromaLuminanceMean, chromaRedMean;
+		yuvConverter->Convert(frame, luminance, lumaRed);
+		yuvConverter->SetChromaRedSaturation(true);
+		yuvConverter->Convert(frame, chromaLuminance, chromaRed);
+
+		ASSERT_EQ(cv::Size(size.width / 2, size.height / 2), chromaRed.size());
+		EXPECT_EQ(0, cv::norm(luminance, chromaLuminance, cv::NORM_INF));
+		cv::Mat blockRed;
+		cv::resize(lumaRed, blockRed, chromaRed.size(), 0, 0, cv::INTER_NEAREST);
+		EXPECT_NEAR(0, cv::norm(blockRed, chromaRed, cv::NORM_INF), 1e-3);
+
+		yuvConverter->ConvertFixed(frame, chromaLuminance, chromaRed, chromaLuminanceMean, chromaRedMean);
+		yuvConverter->SetChromaRedSaturation(false);
+		yuvConverter->ConvertFixed(frame, luminance, lumaRed, luminanceMean, lumaRedMean);
+
+		ASSERT_EQ(cv::Size(size.width / 2, size.height / 2), chromaRed.size());
+		cv::resize(lumaRed, blockRed, chromaRed.size(), 0, 0, cv::INTER_NEAREST);
+		EXPECT_EQ(0, cv::norm(blockRed, chromaRed, cv::NORM_INF));
+		EXPECT_FLOAT_EQ(luminanceMean, chromaLuminanceMean);
+		EXPECT_NEAR(lumaRedMean, chromaRedMean, 1e-3);
+	}
+
+	TEST_F(YuvFrameConverterTests, Red_Edge_In_Chroma_Block)
+	{
+		//the red area ends inside the 2x2 blocks of chroma column edge / 2
+		const int edge = size.width / 2 + 1;
+		cv::Mat bgr(size, CV_8UC3, black);
+		cv::rectangle(bgr, cv::Rect(0, 0, edge, size.height), red, cv::FILLED);
+		YuvFrame frame = ToYuv(bgr);
+
+		cv::Mat luminance, lumaRed, chromaRed;
+		yuvConverter->Convert(frame, luminance, lumaRed);
+		yuvConverter->SetChromaRedSaturation(true);
+		yuvConverter->Convert(frame, luminance, chromaRed);
+		ASSERT_EQ(cv::Size(size.width / 2, size.height / 2), chromaRed.size());
+
+		//the full resolution red saturation keeps the edge at its pixel, the pixels of the edge block share their chroma
+		const float redValue = lumaRed.at<float>(0, 0);
+		EXPECT_GT(redValue, 0);
+		EXPECT_NEAR(redValue, lumaRed.at<float>(0, edge - 2), 1e-3);
+		EXPECT_GT(lumaRed.at<float>(0, edge - 1), lumaRed.at<float>(0, edge));
+		EXPECT_NEAR(0, lumaRed.at<float>(0, edge + 1), 1e-3);
+
+		//the edge block keeps some red but less than its red pixels, the other blocks match their pixels
+		const int edgeBlock = edge / 2;
+		for (int row = 0; row < chromaRed.rows; row++)
+		{
+			EXPECT_GT(chromaRed.at<float>(row, edgeBlock), 0) << "Row: " << row << '\n';
+			EXPECT_LT(chromaRed.at<float>(row, edgeBlock), redValue) << "Row: " << row << '\n';
+			EXPECT_NEAR(redValue, chromaRed.at<float>(row, edgeBlock - 1), 1e-3) << "Row: " << row << '\n';
+			EXPECT_NEAR(0, chromaRed.at<float>(row, edgeBlock + 1), 1e-3) << "Row: " << row << '\n';
+		}
+	}
+}
@@ -41,6 +41,13 @@ namespace EA::EACC::Utils
 		/// <returns></returns>
 		cv::Mat* Convert(cv::Mat& mat);
 
+		/// <summary>
+		/// Converts the values of the matrix into dst, dst is only reallocated if its size or type does not match
+		/// </summary>
+		/// <param name="mat">matrix to convert</param>
+		/// <param name="dst">converted values</param>
+		void Convert(const cv::Mat& mat, cv::Mat& dst);
+
 		/// <summary>
 		/// Returns current values to convert to
 		/// </summary>
@@ -29,4 +29,9 @@ namespace EA::EACC::Utils
 		cv::LUT(bgrMat, *m_pMatValues, *sRgbMat);
 		return sRgbMat;
 	}
+
+	void FrameConverter::Convert(const cv::Mat& bgrMat, cv::Mat& sRgbMat)
+	{
+		cv::LUT(bgrMat, *m_pMatValues, sRgbMat);
+	}
 }
\ No newline at end of file